@@ -0,0 +1,22 @@
+#include "pch.h"
+#include "Adjudicator.h"
+#include <cstdlib>
+
+std::optional<double> Adjudicator::Update(int ply, int whiteScore)
+{
+	const bool isWhiteWinning = (whiteScore > 0);
+	if (abs(whiteScore) < m_Settings.m_WinScore)
+		m_WinCount = 0;
+	else
+		m_WinCount = (m_WinCount > 0 && isWhiteWinning == m_WasWhiteWinning) ? m_WinCount + 1 : 1; //streak of winning side restarts when it changes
+	m_WasWhiteWinning = isWhiteWinning;
+	if (m_WinCount >= m_Settings.m_WinPlies)
+		return isWhiteWinning ? 1.0 : 0.0;
+
+	const bool isDrawish = (ply >= m_Settings.m_DrawMinPly) && (abs(whiteScore) <= m_Settings.m_DrawScore);
+	m_DrawCount = isDrawish ? m_DrawCount + 1 : 0;
+	if ((m_Settings.m_DrawPlies > 0) && (m_DrawCount >= m_Settings.m_DrawPlies))
+		return 0.5;
+
+	return std::nullopt;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include <optional>
+
+/// <summary>Thresholds of game adjudication on search scores</summary>
+struct AdjudicationSettings
+{
+	int m_WinScore = 1000; //in centipawns, both sides have to agree
+	int m_WinPlies = 4; //consecutive plies over win score
+	int m_DrawScore = 10; //in centipawns
+	int m_DrawPlies = 0; //consecutive plies under draw score, no draw adjudication if 0
+	int m_DrawMinPly = 0; //no draw adjudication before
+};
+
+/// <summary>Adjudicates a game before its end, from search scores of consecutive moves</summary>
+class Adjudicator
+{
+public:
+	Adjudicator(const AdjudicationSettings& settings) : m_Settings(settings) {};
+
+	/// <summary>Add search score of the move played at ply, called for each move of the game</summary>
+	/// <param name="whiteScore">score from white point of view, as returned by MoveMaker</param>
+	/// <returns>Result for white once game is adjudicated: 1 for a win, 0.5 for a draw, 0 for a loss</returns>
+	std::optional<double> Update(int ply, int whiteScore);
+
+private:
+	AdjudicationSettings m_Settings;
+	int m_WinCount = 0;
+	int m_DrawCount = 0;
+	bool m_WasWhiteWinning = false;
+};
\ No newline at end of file
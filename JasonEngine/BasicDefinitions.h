@@ -5,9 +5,17 @@
 static constexpr int MaxMoves = 256;
 static constexpr int MaxPly = 256;
 static constexpr int NbOfKillerMoves = 2;
+static constexpr int MaxHistoryScore = 16384; //bound of history heuristic scores, fits in int16_t
+static constexpr int MaxHistoryBonus = 1200; //max history update for a single cutoff
 static constexpr int PerftMaxDepth = 7;
+static constexpr int MaxPvLength = 64; //max length of reported principal variation
+static constexpr int MaxGamePhase = 24; //game phase with all pieces on board, 0 when only kings and pawns are left
 static constexpr int TranspositionTableSizeMb = 24 * 1024 * 1024;//in bytes
 static constexpr int TranspositionTableSize = TranspositionTableSizeMb / 24;//in number of entries
+static constexpr int PawnHashTableSize = 16384; //in number of entries, power of 2
+static constexpr int EvaluationCacheSize = 65536; //in number of entries, power of 2
+static constexpr int MaterialTableSize = 4096; //in number of entries, power of 2
+static constexpr int NormalScaleFactor = 64; //endgame score is multiplied by scale factor / NormalScaleFactor
 static constexpr int Mate = 32000; //has to be under std::numeric_limits<int16_t>::max()
 
 /// <summary> Simple enum for square indices </summary>
@@ -93,6 +101,12 @@ public:
 		return !(*this == move);
 	}
 
+	/// <returns>Same result as operator==, comparing from and to bits directly</returns>
+	inline bool IsSameMove(const Move& move) const
+	{
+		return ((m_Move ^ move.m_Move) & 0x3FFFF) == 0; //bits 0 to 17
+	}
+
 	/// <summary>bits 0 to 5 = From square</summary>
 	inline Square GetFromSquare() const { return static_cast<Square>(m_Move & 0x3f); };
 	/// <summary>bits 6 to 11 = To square</summary>
@@ -255,14 +269,14 @@ public:
 
 	inline void SetPliesFromLastNullMoveBackup(int value)
 	{
-		m_Move &= ~0x7F800000000;
-		m_Move |= static_cast<uint64_t>(value) << 36;
+		m_Move &= ~0xFF000000000;
+		m_Move |= (static_cast<uint64_t>(value) & 0xFF) << 36;
 	}
 
 	inline void SetPliesFromLastIrreversibleMoveBackup(int value)
 	{
-		m_Move &= ~0x7F80000000000;
-		m_Move |= static_cast<uint64_t>(value) << 44;
+		m_Move &= ~0xFF00000000000;
+		m_Move |= (static_cast<uint64_t>(value) & 0xFF) << 44;
 	}
 
 	inline bool IsCastling() const
@@ -299,6 +313,9 @@ public:
 		m_Move = 0x8000000000000000;
 	}
 
+	/// <summary>Whole packed move, including capture and undo backups</summary>
+	inline uint64_t GetPackedMove() const { return m_Move; };
+
 private:
 	uint64_t m_Move = 0;
 };
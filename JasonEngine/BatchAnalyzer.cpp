@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "BatchAnalyzer.h"
+#include "NotationParser.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+BatchAnalyzer::BatchAnalyzer(int threadCount, bool shareTranspositionTable)
+{
+	for (int threadIdx = 0; threadIdx < std::max(threadCount, 1); threadIdx++)
+	{
+		m_MoveMakers.push_back(std::make_unique<MoveMaker>());
+		if (shareTranspositionTable && threadIdx > 0)
+			m_MoveMakers.back()->ShareTranspositionTable(*m_MoveMakers.front());
+	}
+}
+
+void BatchAnalyzer::Analyze(const std::vector<AnalysisRequest>& requests, const ResultCallback& callback)
+{
+	std::atomic<size_t> nextRequest = 0;
+	std::vector<std::thread> threads;
+	for (std::unique_ptr<MoveMaker>& moveMaker : m_MoveMakers)
+	{
+		threads.emplace_back([&, searcher = moveMaker.get()]()
+		{
+			size_t requestIdx = 0;
+			while ((requestIdx = nextRequest++) < requests.size())
+			{
+				AnalysisResult result = AnalyzePosition(*searcher, requests[requestIdx]);
+				result.m_Index = requestIdx;
+
+				std::lock_guard<std::mutex> lock(m_CallbackMutex);
+				callback(result);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+AnalysisResult BatchAnalyzer::AnalyzePosition(MoveMaker& moveMaker, const AnalysisRequest& request)
+{
+	AnalysisResult result;
+	Position position;
+	if (!NotationParser::ParseFEN(request.m_Fen, position))
+		return result;
+
+	//search needs both kings and a legal move
+	const bool hasKings = (position.GetPiecesOfType(PieceType::King, true).CountSetBits() == 1) && (position.GetPiecesOfType(PieceType::King, false).CountSetBits() == 1);
+	if (!hasKings)
+		return result;
+
+	moveMaker.CheckGameOver(position);
+	if (position.GetGameStatus() != Position::GameStatus::Running)
+		return result;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	moveMaker.SetNodeLimit(request.m_Nodes);
+	const int maxDepth = (request.m_Depth > 0) ? request.m_Depth : MaxPvLength;
+	const double moveTime = (request.m_Time > 0.0) ? request.m_Time : 3600.0;
+	const bool isWhiteToPlay = position.IsWhiteToPlay(); //position is updated with best move
+	result.m_IsValid = moveMaker.MakeMove(moveTime, true, 0.0, position, maxDepth, result.m_Score, result.m_Depth);
+	if (!result.m_IsValid)
+		result.m_IsValid = moveMaker.MakeMove(3600.0, true, 0.0, position, 1, result.m_Score, result.m_Depth); //time limit reached before first iteration
+	result.m_Score = isWhiteToPlay ? result.m_Score : -result.m_Score; //MoveMaker score is from white point of view
+	result.m_Time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.m_NodeCount = moveMaker.GetNodeCount();
+
+	const MoveList<MaxPvLength>& principalVariation = moveMaker.GetPrincipalVariation();
+	if (result.m_IsValid)
+		result.m_PrincipalVariation.assign(principalVariation.begin(), principalVariation.end());
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <stdint.h>
+#include "MoveMaker.h"
+
+/// <summary>Position to analyze, with search limits ; search stops at first reached limit</summary>
+struct AnalysisRequest
+{
+	std::string m_Fen;
+	int m_Depth = 0; //0 for no depth limit
+	uint64_t m_Nodes = 0; //0 for no node limit
+	double m_Time = 0.0; //in seconds, 0 for no time limit
+};
+
+struct AnalysisResult
+{
+	size_t m_Index = 0; //index of request
+	bool m_IsValid = false; //false if FEN can't be read, a king is missing or game is already over
+	int m_Score = 0; //for side to move, in centipawns
+	int m_Depth = 0; //depth of last completed iteration
+	uint64_t m_NodeCount = 0;
+	double m_Time = 0.0; //in seconds
+	std::vector<Move> m_PrincipalVariation; //first move is best move
+};
+
+/// <summary>
+/// Analysis of a list of positions, in process: positions are searched in parallel by a pool of move makers, one per worker thread
+/// </summary>
+/// <remark>Move makers, and their transposition tables, are kept from one batch to the next</remark>
+class BatchAnalyzer
+{
+public:
+	/// <summary>Called as soon as a position is analyzed, calls are serialized</summary>
+	using ResultCallback = std::function<void(const AnalysisResult& result)>;
+
+	/// <param name="shareTranspositionTable">all workers use one transposition table, otherwise each worker has its own</param>
+	BatchAnalyzer(int threadCount, bool shareTranspositionTable);
+
+	/// <summary>Analyze positions, idle workers take next position of list so that workers stay busy whatever the cost of each search</summary>
+	/// <remark>Results are reported in completion order, not in request order</remark>
+	void Analyze(const std::vector<AnalysisRequest>& requests, const ResultCallback& callback);
+
+private:
+	static AnalysisResult AnalyzePosition(MoveMaker& moveMaker, const AnalysisRequest& request);
+
+	std::vector<std::unique_ptr<MoveMaker>> m_MoveMakers;
+	std::mutex m_CallbackMutex;
+};
\ No newline at end of file
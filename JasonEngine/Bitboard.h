@@ -679,6 +679,36 @@ static constexpr Bitboard GetFilesOnLeft(int f)
 	return files;
 }
 
+/// <returns>Set bits and all squares north of them</returns>
+static constexpr Bitboard NorthFill(Bitboard bitboard)
+{
+	bitboard |= bitboard << 8;
+	bitboard |= bitboard << 16;
+	bitboard |= bitboard << 32;
+	return bitboard;
+}
+
+/// <returns>Set bits and all squares south of them</returns>
+static constexpr Bitboard SouthFill(Bitboard bitboard)
+{
+	bitboard |= bitboard >> 8;
+	bitboard |= bitboard >> 16;
+	bitboard |= bitboard >> 32;
+	return bitboard;
+}
+
+/// <returns>Files containing at least one set bit of bitboard</returns>
+static constexpr Bitboard FileFill(const Bitboard& bitboard)
+{
+	return NorthFill(SouthFill(bitboard));
+}
+
+/// <returns>Squares directly west and east of set bits</returns>
+static constexpr Bitboard SidesShift(const Bitboard& bitboard)
+{
+	return ((bitboard & ~_h) << 1) | ((bitboard & ~_a) >> 1);
+}
+
 static constexpr std::array<Bitboard, 8> GenerateFilesOnRightOf()
 {
 	std::array<Bitboard, 8> result;
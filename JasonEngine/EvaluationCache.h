@@ -0,0 +1,24 @@
+#pragma once
+#include <memory>
+#include "BasicDefinitions.h"
+
+/// <summary>Evaluation cache entry, static evaluation of a position</summary>
+struct EvaluationCacheEntry
+{
+	uint64_t m_ZobristHash = 0;
+	int m_Score = 0; //score (>0 for white advantage, <0 for black), in centipawns
+};
+
+static_assert((EvaluationCacheSize & (EvaluationCacheSize - 1)) == 0);
+
+/// <summary>Evaluation cache, key is Zobrist hash % size ; entries are always replaced</summary>
+class EvaluationCache
+{
+public:
+	EvaluationCache() { Clear(); };
+	EvaluationCacheEntry& operator[](uint64_t zobristHash) { return (*m_Table)[zobristHash & (EvaluationCacheSize - 1)]; };
+	void Clear() { m_Table.reset(new EC); };
+private:
+	typedef std::array<EvaluationCacheEntry, EvaluationCacheSize> EC;
+	std::unique_ptr<EC> m_Table;
+};
\ No newline at end of file
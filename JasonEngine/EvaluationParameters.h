@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+
+/// <summary>Weights of evaluation terms, in centipawns</summary>
+struct EvaluationParameters
+{
+	int m_BishopPairBonus = 15;
+	int m_CastlingBonus = 50;
+
+	int m_CenterPawnBonus = 40;
+	int m_DoubledPawnPunishment = -20; //40 for a pair
+	int m_IsolatedPawnPunishment = -40;
+	int m_BackwardsPawnPunishment = -20;
+	int m_PassedPawnBonus = 40;
+	std::array<int, 3> m_AdvancedPawnBonus = { 30, 40, 50 }; //on rows 5, 6, 7 or 4, 3, 2
+	int m_SquareBehindPawnBonus = 1;
+
+	int m_KnightEndgamePunishment = -10;
+	int m_BishopEndgamePunishment = 10;
+
+	int m_RookOnSemiOpenFileBonus = 20;
+	int m_RookOnOpenFileBonus = 30;
+
+	int m_Blocking_d_or_ePawnPunishment = -40; //Punishment for blocking unmoved pawns on d and e files
+
+	int m_KnightPawnBonus = 2; //Knights better with lots of pawns
+	int m_BishopPawnPunishment = -2; //Bishops worse with lots of pawns
+	int m_RookPawnPunishment = -2; //Rooks worse with lots of pawns
+
+	int m_AttackedSquareBonusFactor = 0;
+	int m_CenterAttackedBonusFactor = 1; //Factor to multiply with how many center squares are attacked by own pieces
+	int m_KingSquaresAttackBonusFactor = 5; //Factor to multiply with how many squares around enemy king that are attacked by own pieces
+
+	int m_SamePieceTwicePunishment = -50; //Penaly for moving same piece twice in opening
+	int m_TempoBonus = 30;
+
+	std::array<int, 4> m_MobilityBonus = { 4, 4, 2, 1 }; //per square reachable by knight, bishop, rook, queen, not attacked by enemy pawns
+	std::array<int, 4> m_KingAttackerWeight = { 10, 10, 15, 30 }; //per knight, bishop, rook, queen attacking squares around enemy king
+};
+
+/// <summary>Parameters policy of evaluation: default weights, known at compile time so they are folded into the code</summary>
+struct DefaultParameters
+{
+	static constexpr EvaluationParameters Values = {};
+};
+
+/// <summary>Parameters policy of evaluation: weights loaded at runtime, for tuning</summary>
+struct TunableParameters
+{
+	static inline EvaluationParameters Values = {};
+};
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "pch.h"
+#include "GameLoop.h"
+
+double GameLoop::Play(Position& position, const AdjudicationSettings& adjudication, MoveMaker& referee, const PlayMove& playMove)
+{
+	Adjudicator adjudicator(adjudication);
+	for (int ply = 0; position.GetMoves().size() < MaxGamePlies; ply++)
+	{
+		const bool isWhiteToPlay = position.IsWhiteToPlay();
+		int whiteScore = 0;
+		if (!playMove(position, ply, whiteScore))
+			return isWhiteToPlay ? 0.0 : 1.0;
+
+		referee.CheckGameOver(position);
+		switch (position.GetGameStatus())
+		{
+			case Position::GameStatus::Draw:
+				return 0.5;
+			case Position::GameStatus::CheckMate:
+				return isWhiteToPlay ? 1.0 : 0.0;
+			default:
+				break;
+		}
+
+		if (const std::optional<double> result = adjudicator.Update(ply, whiteScore))
+			return *result;
+	}
+
+	return 0.5;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <functional>
+#include "Position.h"
+#include "MoveMaker.h"
+#include "Adjudicator.h"
+
+/// <summary>Game loop shared by self-play, matches and data generation: moves are played until game over, adjudication or max game length</summary>
+class GameLoop
+{
+public:
+	/// <summary>Play a move on position, called once per ply</summary>
+	/// <param name="whiteScore">search score of the move, from white point of view</param>
+	/// <returns>False if side to play lost: no move found, illegal move or time out</returns>
+	using PlayMove = std::function<bool(Position& position, int ply, int& whiteScore)>;
+
+	/// <summary>Play game from position, which may already contain opening moves</summary>
+	/// <param name="referee">move maker checking checkmate, stalemate, repetition and insufficient material after each move</param>
+	/// <returns>Result for white: 1 for a win, 0.5 for a draw (including max game length), 0 for a loss</returns>
+	static double Play(Position& position, const AdjudicationSettings& adjudication, MoveMaker& referee, const PlayMove& playMove);
+
+	static constexpr int OpeningPlies = 8; //max random plies played before self-play games
+	static constexpr size_t MaxGamePlies = MaxPly - MaxPvLength; //positions keep at most MaxPly moves, including opening and searched moves
+};
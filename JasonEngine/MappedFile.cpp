@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#define NOMINMAX
+#include <windows.h>
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+	m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE)
+	{
+		m_File = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_File, &fileSize))
+	{
+		Close();
+		return false;
+	}
+
+	if (fileSize.QuadPart == 0)
+		return true; //empty files can't be mapped
+
+	m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_Mapping != nullptr)
+		m_Data = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (m_Data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data != nullptr)
+		UnmapViewOfFile(m_Data);
+	if (m_Mapping != nullptr)
+		CloseHandle(m_Mapping);
+	if (m_File != nullptr)
+		CloseHandle(m_File);
+
+	m_Data = nullptr;
+	m_Mapping = nullptr;
+	m_File = nullptr;
+	m_Size = 0;
+}
\ No newline at end of file
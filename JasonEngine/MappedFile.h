@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <stdint.h>
+
+/// <summary>Read only memory mapping of a whole file, e.g. to read large data files in place</summary>
+class MappedFile
+{
+public:
+	MappedFile() {};
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); };
+
+	/// <returns>False if file can't be mapped, true for an empty file</returns>
+	bool Open(const std::string& path);
+	void Close();
+
+	const char* data() const { return m_Data; };
+	size_t size() const { return m_Size; };
+
+private:
+	void* m_File = nullptr; //file and mapping handles
+	void* m_Mapping = nullptr;
+	const char* m_Data = nullptr;
+	size_t m_Size = 0;
+};
\ No newline at end of file
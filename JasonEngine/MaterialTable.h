@@ -0,0 +1,28 @@
+#pragma once
+#include <memory>
+#include "BasicDefinitions.h"
+
+/// <summary>Material table entry, evaluation of a set of piece counts</summary>
+struct MaterialTableEntry
+{
+	uint64_t m_MaterialKey = ~0ULL; //no position has all piece counts set to 15, entry is empty
+	int m_Score = 0; //imbalance score (>0 for white advantage, <0 for black), in centipawns
+	int m_GamePhase = 0; //from MaxGamePhase (opening) to 0 (pawn endgame)
+	int m_WhiteScaleFactor = NormalScaleFactor; //scale factor of endgame score when white is ahead
+	int m_BlackScaleFactor = NormalScaleFactor;
+	bool m_IsBishopsEnding = false; //one bishop each and no other piece, drawish if bishops are on opposite colors
+};
+
+static_assert((MaterialTableSize & (MaterialTableSize - 1)) == 0);
+
+/// <summary>Material table, key is a mix of material key bits % size since material keys are mostly made of low counts</summary>
+class MaterialTable
+{
+public:
+	MaterialTable() { Clear(); };
+	MaterialTableEntry& operator[](uint64_t materialKey) { return (*m_Table)[((materialKey * 0x9E3779B97F4A7C15ULL) >> 32) & (MaterialTableSize - 1)]; };
+	void Clear() { m_Table.reset(new MT); };
+private:
+	typedef std::array<MaterialTableEntry, MaterialTableSize> MT;
+	std::unique_ptr<MT> m_Table;
+};
\ No newline at end of file
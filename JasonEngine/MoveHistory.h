@@ -0,0 +1,72 @@
+#pragma once
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
+#include "BasicDefinitions.h"
+
+/// <summary>Statistics used to sort quiet moves: butterfly history, countermoves and continuation history</summary>
+/// <remark>Scores are updated with a gravity formula, keeping them within [-MaxHistoryScore, MaxHistoryScore] without periodic rescaling</remark>
+class MoveHistory
+{
+public:
+	MoveHistory() { m_Tables.reset(new Tables); };
+
+	void Clear() { m_Tables.reset(new Tables); };
+
+	/// <summary>Score of a quiet move, sum of butterfly history and continuation history of previous move</summary>
+	/// <param name="previousMove">last move played in the position, may be a null move</param>
+	int GetScore(const Move& move, const Move& previousMove, bool isWhite) const
+	{
+		int score = m_Tables->m_ButterflyHistory[isWhite][move.GetFromSquare()][move.GetToSquare()];
+		if (!previousMove.IsNullMove())
+			score += m_Tables->m_ContinuationHistory[isWhite][static_cast<int>(previousMove.GetToType())][previousMove.GetToSquare()][static_cast<int>(move.GetFromType())][move.GetToSquare()];
+
+		return score;
+	}
+
+	/// <returns>Quiet move which last refuted previousMove, empty move if none</returns>
+	Move GetCounterMove(const Move& previousMove, bool isWhite) const
+	{
+		if (previousMove.IsNullMove())
+			return previousMove;
+
+		return m_Tables->m_CounterMoves[isWhite][previousMove.GetFromSquare()][previousMove.GetToSquare()];
+	}
+
+	/// <summary>Reward quiet move which produced a beta cutoff and penalize quiet moves searched before it</summary>
+	/// <param name="searchedQuietMoves">quiet moves which failed to produce a cutoff</param>
+	void Update(const Move& bestMove, const Move& previousMove, const MoveList<MaxMoves>& searchedQuietMoves, bool isWhite, int depth)
+	{
+		const int bonus = std::min(16 * depth * depth, MaxHistoryBonus);
+
+		UpdateScores(bestMove, previousMove, isWhite, bonus);
+		for (const Move& move : searchedQuietMoves)
+			UpdateScores(move, previousMove, isWhite, -bonus);
+
+		if (!previousMove.IsNullMove())
+			m_Tables->m_CounterMoves[isWhite][previousMove.GetFromSquare()][previousMove.GetToSquare()] = bestMove;
+	}
+
+private:
+	void UpdateScores(const Move& move, const Move& previousMove, bool isWhite, int bonus)
+	{
+		ApplyGravity(m_Tables->m_ButterflyHistory[isWhite][move.GetFromSquare()][move.GetToSquare()], bonus);
+		if (!previousMove.IsNullMove())
+			ApplyGravity(m_Tables->m_ContinuationHistory[isWhite][static_cast<int>(previousMove.GetToType())][previousMove.GetToSquare()][static_cast<int>(move.GetFromType())][move.GetToSquare()], bonus);
+	}
+
+	/// <summary>Score moves towards bonus, the closer score is to MaxHistoryScore the smaller the update</summary>
+	static void ApplyGravity(int16_t& score, int bonus)
+	{
+		score += static_cast<int16_t>(bonus - score * abs(bonus) / MaxHistoryScore);
+	}
+
+	struct Tables
+	{
+		std::array<std::array<std::array<int16_t, 64>, 64>, 2> m_ButterflyHistory = {}; //[side to move][from][to]
+		std::array<std::array<std::array<Move, 64>, 64>, 2> m_CounterMoves = {}; //[side to move][previous from][previous to]
+		std::array<std::array<std::array<std::array<std::array<int16_t, 64>, 6>, 64>, 6>, 2> m_ContinuationHistory = {}; //[side to move][previous piece][previous to][piece][to]
+	};
+
+	std::unique_ptr<Tables> m_Tables;
+};
\ No newline at end of file
@@ -4,9 +4,23 @@
 #include <string>
 #include <assert.h>
 #include <algorithm>
+#include <limits>
 
 bool MoveMaker::MakeMove(double time, bool isMoveTime, double increment, Position& position, int maxDepth, int& score, int& searchDepth)
 {
+	std::optional<Move> bookMove = (m_Book != nullptr) ? m_Book->GetMove(position, m_BookGenerator) : std::nullopt;
+	if (bookMove.has_value())
+	{
+		//book moves aren't searched, principal variation is the book move only
+		m_PrincipalVariation.clear();
+		m_PrincipalVariation.push_back(*bookMove);
+		m_NodeCount = 0;
+		score = 0;
+		searchDepth = 0;
+		position.Update(*bookMove);
+		return true;
+	}
+
 	if (isMoveTime)
 		m_TimeManager.SetMoveTime(time);
 	else
@@ -30,23 +44,51 @@ bool MoveMaker::MakeMove(Position& position, int maxDepth, int& score)
 	return MakeMove(3600.0, false, 0.0, position, maxDepth, score, searchDepth);
 }
 
+void MoveMaker::SetSearchParameters(const SearchParameters& parameters)
+{
+	m_SearchParameters = parameters;
+	m_TimeManager.SetMoveTimeFactor(parameters.m_MoveTimePercent / 100.0);
+	m_TimeManager.SetNewIterationTimeFactor(parameters.m_NewIterationTimeFactor);
+}
+
+bool MoveMaker::IsSearchStopped()
+{
+	//node limit is only checked once first iteration is complete, so that a move is always found
+	return m_TimeManager.IsTimeOut() || ((m_NodeLimit != 0) && (m_NodeCount >= m_NodeLimit) && !m_PrincipalVariation.empty());
+}
+
+int MoveMaker::GetQuiescentScore(Position& position)
+{
+	m_TimeManager.SetMoveTime(3600.0);
+	m_TimeManager.InitStartTime();
+	m_RootMoveCount = position.GetMoves().size();
+
+	const bool isWhiteToPlay = position.IsWhiteToPlay();
+	const int score = QuiescentSearch(position, 0, -Mate, Mate, isWhiteToPlay);
+	return isWhiteToPlay ? score : -score;
+}
+
 std::optional<Move> MoveMaker::FindMove(Position& position, int maxDepth, int& score, int& searchDepth)
 {
 	int alpha = -Mate;
 	int beta = Mate;
-	constexpr int aspirationWindowSize = 10; //may use 25 to 50 (1/4 to 1/2 pawn) in the future with more complicated evaluation function
+	const int aspirationWindowSize = m_SearchParameters.m_AspirationWindowSize;
 	int aspirationWindowFailCount = 0;
 	std::optional<Move> bestMove;
 	score = std::numeric_limits<int>::lowest();
 	const bool allowNullMove = false;
 	m_KillerMoves = {};
+	m_MoveHistory.Clear();
+	m_PrincipalVariation.clear();
+	m_NodeCount = 0;
+	m_RootMoveCount = position.GetMoves().size();
 
 	double lastIterationDuration = 0.0;
 
 	//Iterative deepening
 	for (searchDepth = 1; searchDepth <= maxDepth; searchDepth++)
 	{
-		if ((searchDepth > 1) && !m_TimeManager.HasTimeForNewIteration(m_TimeManager.GetCounterDiff()))
+		if ((searchDepth > 1) && (!m_TimeManager.HasTimeForNewIteration(m_TimeManager.GetCounterDiff()) || IsSearchStopped()))
 		{
 			searchDepth--;
 			break;
@@ -57,7 +99,7 @@ std::optional<Move> MoveMaker::FindMove(Position& position, int maxDepth, int& s
 		const int moveScore = Search(position, searchDepth, 0, alpha, beta, position.IsWhiteToPlay(), allowNullMove, move);
 		m_TimeManager.EndCounter();
 
-		if (m_TimeManager.IsTimeOut())
+		if (IsSearchStopped())
 		{
 			//Can't use result of incomplete search because of terminated quiescence search
 			searchDepth--;
@@ -68,8 +110,28 @@ std::optional<Move> MoveMaker::FindMove(Position& position, int maxDepth, int& s
 		bestMove = move;
 		score = moveScore;
 
+		const bool isMateFound = (score > (Mate - MaxPly));
+		if (isMateFound || ((alpha < score) && (score < beta)))
+		{
+			//iteration is complete, keep its principal variation for reporting and next iteration move ordering
+			m_PrincipalVariation = m_PrincipalVariationTable[0];
+			if (m_PrincipalVariation.empty() || (m_PrincipalVariation.front() != *bestMove))
+				m_PrincipalVariation = { *bestMove }; //root score came from transposition table
+
+			if (m_IterationCallback)
+			{
+				SearchInfo info;
+				info.m_Depth = searchDepth;
+				info.m_Score = score;
+				info.m_NodeCount = m_NodeCount;
+				info.m_Time = m_TimeManager.GetTimeSpent();
+				info.m_PrincipalVariation = &m_PrincipalVariation;
+				m_IterationCallback(info);
+			}
+		}
+
 		//break if mate found
-		if (score > (Mate - MaxPly))
+		if (isMateFound)
 			break;
 
 		if (score <= alpha)
@@ -153,48 +215,22 @@ void MoveMaker::CheckGameOver(Position& position, int ply)
 
 int MoveMaker::Search(Position& position, int depth, int ply, int alpha, int beta, bool maximizeWhite, bool allowNullMove, std::optional<Move>& bestMove)
 {
-	const int originalAlpha = alpha;
+	if (depth <= 0)
+		return QuiescentSearch(position, ply, alpha, beta, maximizeWhite);
 
-	//Transposition table lookup
-	const size_t transpositionTableKey = GetTranspositionTableKey(position);
-	if (!position.IsRepetition()) //Repetition would affect the score, can't use TT
-	{
-		
-		if ((m_TranspositionTable[transpositionTableKey].m_ZobristHash == position.GetZobristHash()) &&
-			(m_TranspositionTable[transpositionTableKey].m_Depth >= depth))
-		{
-			switch (m_TranspositionTable[transpositionTableKey].m_Flag)
-			{
-			case TranspositionTableEntry::Flag::Exact:
-			{
-				bestMove = m_TranspositionTable[transpositionTableKey].m_BestMove;
-				return m_TranspositionTable[transpositionTableKey].m_Score;
-				break;
-			}
-			case TranspositionTableEntry::Flag::LowerBound:
-				alpha = std::max(alpha, static_cast<int>(m_TranspositionTable[transpositionTableKey].m_Score));
-				break;
-			case TranspositionTableEntry::Flag::UpperBound:
-				beta = std::min(beta, static_cast<int>(m_TranspositionTable[transpositionTableKey].m_Score));
-				break;
-			default:
-				assert(false);
-				break;
-			}
+	m_NodeCount++;
+	if (ply < MaxPvLength)
+		m_PrincipalVariationTable[ply].clear();
 
-			if (alpha >= beta)
-			{
-				bestMove = m_TranspositionTable[transpositionTableKey].m_BestMove;
-				return m_TranspositionTable[transpositionTableKey].m_Score;
-			}
-		}
-	}
+	const int originalAlpha = alpha;
 
-	if (depth <= 0)
-		return QuiescentSearch(position, ply, alpha, beta, maximizeWhite);
+	//Transposition table lookup
+	int transpositionTableScore = 0;
+	if (ProbeTranspositionTable(position, depth, alpha, beta, transpositionTableScore, bestMove))
+		return transpositionTableScore;
 
 	//Null move heuristic
-	constexpr int R = 2; //reduced depth constant
+	const int R = m_SearchParameters.m_NullMoveReduction; //reduced depth constant
 	if (allowNullMove  && depth - 1 - R >= 0)
 	{
 		if (!MoveSearcher::IsKingInCheckFromBitboards(position, position.IsWhiteToPlay()))
@@ -209,11 +245,58 @@ int MoveMaker::Search(Position& position, int depth, int ply, int alpha, int bet
 			if (score >= beta)
 				return score;//cutoff
 
-			if (m_TimeManager.IsTimeOut())
+			if (IsSearchStopped())
 				return score;
 		}
 	}
 
+	//ProbCut: a good capture which holds against a raised beta with a reduced depth search will very likely produce a cutoff at full depth
+	const int probCutMinDepth = m_SearchParameters.m_ProbCutMinDepth;
+	const int probCutDepthReduction = m_SearchParameters.m_ProbCutDepthReduction;
+	const int probCutBeta = beta + m_SearchParameters.m_ProbCutMargin;
+	if ((depth >= probCutMinDepth) && (beta - alpha == 1) && (abs(beta) < Mate - MaxPly))
+	{
+		MoveList<MaxMoves>& captures = m_MoveLists[ply];
+		MoveSearcher::GetLegalCapturesFromBitboards(position, captures);
+		SortMoves(position, ply, captures);
+		for (Move& capture : captures)
+		{
+			if (MoveSearcher::StaticExchangeEvaluation(position, capture) < 0)
+				continue;
+
+			position.Update(capture);
+			std::optional<Move> bestMoveDummy;
+			//verify with quiescent search first, cheaper
+			int score = -QuiescentSearch(position, ply + 1, -probCutBeta, -probCutBeta + 1, !maximizeWhite);
+			if (score >= probCutBeta)
+				score = -Search(position, depth - probCutDepthReduction, ply + 1, -probCutBeta, -probCutBeta + 1, !maximizeWhite, !allowNullMove, bestMoveDummy);
+			position.Undo(capture);
+
+			if (IsSearchStopped())
+				return score;
+
+			if (score >= probCutBeta)
+				return score; //cutoff
+		}
+	}
+
+	//Without a TT move, move ordering is poor: at PV nodes, a reduced depth search finds a first move (internal iterative deepening),
+	//at other nodes, depth is reduced instead (internal iterative reduction)
+	const int internalIterativeDepth = m_SearchParameters.m_InternalIterativeDepth; //min depth for internal iterative deepening or reduction
+	if ((depth >= internalIterativeDepth) && !HasTranspositionTableMove(position))
+	{
+		const bool isPvNode = (beta - alpha > 1);
+		if (isPvNode)
+		{
+			std::optional<Move> bestMoveDummy;
+			Search(position, depth - 2, ply, alpha, beta, maximizeWhite, allowNullMove, bestMoveDummy);
+			if (IsSearchStopped())
+				return alpha;
+		}
+		else
+			depth--;
+	}
+
 	MoveList<MaxMoves>& childMoves = m_MoveLists[ply];
 	MoveSearcher::GetLegalMovesFromBitboards(position, childMoves);
 
@@ -222,14 +305,17 @@ int MoveMaker::Search(Position& position, int depth, int ply, int alpha, int bet
 
 	//Sort moves
 	SortMoves(position, ply, childMoves);
+	SortPrincipalVariationMove(position, ply, childMoves);
 
 	//Search child nodes
 	int value = std::numeric_limits<int>::lowest();
 	bool isFirstChild = true;
+	const Move previousMove = GetPreviousMove(position);
+	MoveList<MaxMoves> searchedQuietMoves;
 	for (Move& childMove : childMoves)
 	{
 		position.Update(childMove);
-		std::optional<Move> bestMoveDummy; //only returns best move from 0 depth
+		std::optional<Move> bestMoveDummy; //best move of child nodes is retrieved from principal variation table
 		int score = 0;
 
 		if (isFirstChild)
@@ -250,43 +336,94 @@ int MoveMaker::Search(Position& position, int depth, int ply, int alpha, int bet
 		{
 			value = score;
 			bestMove = childMove;
+			UpdatePrincipalVariation(ply, childMove);
 		}
 
 		alpha = std::max(alpha, value);
 
 		if (alpha >= beta)
 		{
-			//Store killer move
+			//Store killer move and update quiet moves history
 			if (!childMove.IsCapture())
 			{
 				std::rotate(m_KillerMoves[ply].begin(), m_KillerMoves[ply].end() - 1, m_KillerMoves[ply].end());
 				m_KillerMoves[ply][0] = childMove;
+				m_MoveHistory.Update(childMove, previousMove, searchedQuietMoves, position.IsWhiteToPlay(), depth);
 			}
 
 			break;//cutoff
 		}
 
-		if (m_TimeManager.IsTimeOut())
+		if (!childMove.IsCapture())
+			searchedQuietMoves.push_back(childMove);
+
+		if (IsSearchStopped())
 			return value;
 	}
 
 	//Transposition Table Store
-	m_TranspositionTable[transpositionTableKey].m_ZobristHash = position.GetZobristHash();
-	assert(abs(value) <= Mate);
-	m_TranspositionTable[transpositionTableKey].m_Score = value;
-	m_TranspositionTable[transpositionTableKey].m_Depth = depth;
 	assert(bestMove.has_value());
-	m_TranspositionTable[transpositionTableKey].m_BestMove = *bestMove;
-	if (value <= originalAlpha)
-		m_TranspositionTable[transpositionTableKey].m_Flag = TranspositionTableEntry::Flag::UpperBound;
-	else if (value >= beta)
-		m_TranspositionTable[transpositionTableKey].m_Flag = TranspositionTableEntry::Flag::LowerBound;
-	else
-		m_TranspositionTable[transpositionTableKey].m_Flag = TranspositionTableEntry::Flag::Exact;
+	StoreTranspositionTable(position, depth, value, originalAlpha, beta, *bestMove);
 
 	return value;
 }
 
+bool MoveMaker::HasTranspositionTableMove(const Position& position) const
+{
+	//empty move is stored as a1a1
+	const TranspositionTableEntry entry = m_TranspositionTable[GetTranspositionTableKey(position)];
+	return entry.IsFor(position.GetZobristHash()) && (entry.m_BestMove.GetFrom() != entry.m_BestMove.GetTo());
+}
+
+bool MoveMaker::ProbeTranspositionTable(const Position& position, int depth, int& alpha, int& beta, int& score, std::optional<Move>& bestMove)
+{
+	if (position.IsRepetition()) //Repetition would affect the score, can't use TT
+		return false;
+
+	//entry is copied before being checked, a shared table can be written by other threads meanwhile
+	const TranspositionTableEntry entry = m_TranspositionTable[GetTranspositionTableKey(position)];
+	if (!entry.IsFor(position.GetZobristHash()) || (entry.m_Depth < depth))
+		return false;
+
+	switch (entry.m_Flag)
+	{
+	case TranspositionTableEntry::Flag::Exact:
+		bestMove = entry.m_BestMove;
+		score = entry.m_Score;
+		return true;
+	case TranspositionTableEntry::Flag::LowerBound:
+		alpha = std::max(alpha, static_cast<int>(entry.m_Score));
+		break;
+	case TranspositionTableEntry::Flag::UpperBound:
+		beta = std::min(beta, static_cast<int>(entry.m_Score));
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	if (alpha >= beta)
+	{
+		bestMove = entry.m_BestMove;
+		score = entry.m_Score;
+		return true;
+	}
+
+	return false;
+}
+
+void MoveMaker::StoreTranspositionTable(const Position& position, int depth, int score, int originalAlpha, int beta, const Move& bestMove)
+{
+	assert(abs(score) <= Mate);
+	TranspositionTableEntry::Flag flag = TranspositionTableEntry::Flag::Exact;
+	if (score <= originalAlpha)
+		flag = TranspositionTableEntry::Flag::UpperBound;
+	else if (score >= beta)
+		flag = TranspositionTableEntry::Flag::LowerBound;
+
+	m_TranspositionTable[GetTranspositionTableKey(position)].Store(position.GetZobristHash(), flag, depth, score, bestMove);
+}
+
 int MoveMaker::Minimax(Position& position, int depth, bool maximizeWhite, std::optional<Move>& bestMove)
 {
 	if (depth == 0)
@@ -338,65 +475,120 @@ int MoveMaker::Minimax(Position& position, int depth, bool maximizeWhite, std::o
 	}
 }
 
+/// <returns>Value of piece captured by move, pawn if none (en passant)</returns>
+static int GetCapturedPieceValue(const Position& position, const Move& move)
+{
+	const Bitboard toSquare(move.GetToSquare());
+	for (int type = static_cast<int>(PieceType::Queen); type > static_cast<int>(PieceType::Pawn); type--)
+	{
+		if (position.GetPiecesOfType(static_cast<PieceType>(type), !position.IsWhiteToPlay()) & toSquare)
+			return PositionEvaluation::GetPieceValue(static_cast<PieceType>(type));
+	}
+
+	return PositionEvaluation::GetPieceValue(PieceType::Pawn);
+}
+
 int MoveMaker::QuiescentSearch(Position& position, int ply, int alpha, int beta, bool maximizeWhite)
 {
-	const int standPat = (maximizeWhite ? 1 : -1) * EvaluatePosition(position, ply);
+	m_NodeCount++;
+	if (ply < MaxPvLength)
+		m_PrincipalVariationTable[ply].clear();
+
+	const int originalAlpha = alpha;
+
+	//Transposition table lookup, any stored depth is deep enough
+	std::optional<Move> bestMove;
+	int transpositionTableScore = 0;
+	if (ProbeTranspositionTable(position, 0, alpha, beta, transpositionTableScore, bestMove))
+		return transpositionTableScore;
+
+	//Stand pat, evaluation may be lazy far outside of window
+	const int standPat = maximizeWhite ? EvaluatePosition(position, ply, alpha, beta) : -EvaluatePosition(position, ply, -beta, -alpha);
 	if (standPat >= beta)
 		return beta;
 	if (alpha < standPat)
 		alpha = standPat;
 
 	MoveList<MaxMoves>& childMoves = m_MoveLists[ply];
-	MoveSearcher::GetLegalMovesFromBitboards(position, childMoves);
-
-	if (childMoves.empty())
-		return standPat;
+	MoveSearcher::GetLegalCapturesFromBitboards(position, childMoves);
 
 	//Sort moves
 	SortMoves(position, ply, childMoves);
 
 	//Search child capture nodes
+	const int deltaPruningMargin = m_SearchParameters.m_DeltaPruningMargin; //safety margin for positional gains of a capture
+	bestMove.reset();
 	for (Move& childMove : childMoves)
 	{
-		position.Update(childMove);
-		if (childMove.IsCapture())
-		{
-			const int score = -QuiescentSearch(position, ply + 1, -beta, -alpha, !maximizeWhite);
+		//Delta pruning: capture can't raise alpha even when winning captured piece for free
+		if (!childMove.IsQueening() && (standPat + GetCapturedPieceValue(position, childMove) + deltaPruningMargin < alpha))
+			continue;
 
-			if (score >= beta)
-			{
-				position.Undo(childMove);
-				return beta;
-			}
-			if (score > alpha)
-				alpha = score;
-		}
+		//Skip captures losing material
+		if (MoveSearcher::StaticExchangeEvaluation(position, childMove) < 0)
+			continue;
+
+		position.Update(childMove);
+		const int score = -QuiescentSearch(position, ply + 1, -beta, -alpha, !maximizeWhite);
 		position.Undo(childMove);
 
-		if (m_TimeManager.IsTimeOut())
+		if (IsSearchStopped())
 			return alpha;
+
+		if (score >= beta)
+		{
+			StoreQuiescentTranspositionTable(position, beta, originalAlpha, beta, childMove);
+			return beta;
+		}
+		if (score > alpha)
+		{
+			alpha = score;
+			bestMove = childMove;
+		}
 	}
 
+	StoreQuiescentTranspositionTable(position, alpha, originalAlpha, beta, bestMove.value_or(Move()));
 	return alpha;
 }
 
-int MoveMaker::EvaluatePosition(Position& position, int ply)
+void MoveMaker::StoreQuiescentTranspositionTable(const Position& position, int score, int originalAlpha, int beta, const Move& bestMove)
+{
+	//Never replace entries from main search with depth 0 entries
+	if (m_TranspositionTable[GetTranspositionTableKey(position)].m_Depth == 0)
+		StoreTranspositionTable(position, 0, score, originalAlpha, beta, bestMove);
+}
+
+int MoveMaker::EvaluatePosition(Position& position, int ply, int alpha, int beta)
 {
 	MoveMaker::CheckGameOver(position, ply);
-	const int score = PositionEvaluation::EvaluatePosition(position, ply);
+	const int score = PositionEvaluation::EvaluatePosition(position, ply, alpha, beta);
 	position.SetGameStatus(Position::GameStatus::Running);
 	return score;
 }
 
 void MoveMaker::SortMoves(const Position& position, int ply, MoveList<MaxMoves>& moves)
 {
-	std::sort(moves.begin(), moves.end(), [&position, &ply, this](const Move& move1, const Move& move2)->bool { return MovesSorter(position, ply, move1, move2); });
+	//quiet moves keys are computed once, not on each comparison
+	const Move previousMove = GetPreviousMove(position);
+	const Move counterMove = m_MoveHistory.GetCounterMove(previousMove, position.IsWhiteToPlay());
+	const Bitboard& enemyPieces = (position.IsWhiteToPlay() ? position.GetBlackPieces() : position.GetWhitePieces());
+	std::array<std::pair<int, Move>, MaxMoves> keyedMoves;
+	for (size_t i = 0; i < moves.size(); i++)
+	{
+		const bool isQuiet = !(Bitboard(moves[i].GetToSquare()) & enemyPieces);
+		keyedMoves[i] = { isQuiet ? GetQuietMoveKey(moves[i], previousMove, counterMove, position.IsWhiteToPlay()) : 0, moves[i] };
+	}
+
+	std::sort(keyedMoves.begin(), keyedMoves.begin() + moves.size(), [&position, &ply, this](const std::pair<int, Move>& move1, const std::pair<int, Move>& move2)->bool
+		{ return MovesSorter(position, ply, move1.second, move2.second, move1.first, move2.first); });
+	for (size_t i = 0; i < moves.size(); i++)
+		moves[i] = keyedMoves[i].second;
 
 	//Best move from previous iteration is picked as best guess
-	const size_t transpositionTableKey = GetTranspositionTableKey(position);
-	if (m_TranspositionTable[transpositionTableKey].m_ZobristHash == position.GetZobristHash())
+	const TranspositionTableEntry entry = m_TranspositionTable[GetTranspositionTableKey(position)];
+	if (entry.IsFor(position.GetZobristHash()))
 	{
-		const Move& previousBest = m_TranspositionTable[transpositionTableKey].m_BestMove;
+		const Move& previousBest = entry.m_BestMove;
 		MoveList<MaxMoves>::const_iterator searchIt = std::find(moves.begin(), moves.end(), previousBest);
 		if (searchIt != moves.end())
 		{
@@ -410,11 +602,28 @@ void MoveMaker::SortMoves(const Position& position, int ply, MoveList<MaxMoves>&
 	}
 }
 
+int MoveMaker::GetQuietMoveKey(const Move& move, const Move& previousMove, const Move& counterMove, bool isWhite) const
+{
+	if (move.IsSameMove(counterMove))
+		return std::numeric_limits<int>::max();
+
+	return m_MoveHistory.GetScore(move, previousMove, isWhite);
+}
+
 bool MoveMaker::MovesSorter(const Position& position, int ply, const Move& move1, const Move& move2)
+{
+	const Move previousMove = GetPreviousMove(position);
+	const Move counterMove = m_MoveHistory.GetCounterMove(previousMove, position.IsWhiteToPlay());
+	return MovesSorter(position, ply, move1, move2, GetQuietMoveKey(move1, previousMove, counterMove, position.IsWhiteToPlay()),
+		GetQuietMoveKey(move2, previousMove, counterMove, position.IsWhiteToPlay()));
+}
+
+bool MoveMaker::MovesSorter(const Position& position, int ply, const Move& move1, const Move& move2, int quietKey1, int quietKey2) const
 {
 	//Killer Moves
-	const bool isMove1Killer = std::find(m_KillerMoves[ply].begin(), m_KillerMoves[ply].end(), move1) != m_KillerMoves[ply].end();
-	const bool isMove2Killer = std::find(m_KillerMoves[ply].begin(), m_KillerMoves[ply].end(), move2) != m_KillerMoves[ply].end();
+	const std::array<Move, NbOfKillerMoves>& killerMoves = m_KillerMoves[ply];
+	const bool isMove1Killer = std::any_of(killerMoves.begin(), killerMoves.end(), [&move1](const Move& killerMove) { return killerMove.IsSameMove(move1); });
+	const bool isMove2Killer = std::any_of(killerMoves.begin(), killerMoves.end(), [&move2](const Move& killerMove) { return killerMove.IsSameMove(move2); });
 	if (isMove1Killer && !isMove2Killer)
 		return true;
 	else if (!isMove1Killer && isMove2Killer)
@@ -453,9 +662,57 @@ bool MoveMaker::MovesSorter(const Position& position, int ply, const Move& move1
 			return false;
 	}
 
+	//Quiet moves, countermove first then sorted by history scores
+	if (!(toSquare1 & enemyPieces) && !(toSquare2 & enemyPieces))
+		return quietKey1 > quietKey2;
+
 	return false;
 }
 
+void MoveMaker::UpdatePrincipalVariation(int ply, const Move& move)
+{
+	if (ply >= MaxPvLength)
+		return;
+
+	MoveList<MaxPvLength>& principalVariation = m_PrincipalVariationTable[ply];
+	principalVariation.clear();
+	principalVariation.push_back(move);
+	if (ply + 1 < MaxPvLength)
+	{
+		const MoveList<MaxPvLength>& childPrincipalVariation = m_PrincipalVariationTable[ply + 1];
+		const size_t childLength = std::min(childPrincipalVariation.size(), static_cast<size_t>(MaxPvLength - 1));
+		principalVariation.insert(principalVariation.end(), childPrincipalVariation.begin(), childPrincipalVariation.begin() + childLength);
+	}
+}
+
+void MoveMaker::SortPrincipalVariationMove(const Position& position, int ply, MoveList<MaxMoves>& moves)
+{
+	if (ply >= static_cast<int>(m_PrincipalVariation.size()))
+		return;
+
+	//check that position was reached by following previous principal variation from root
+	for (int i = 0; i < ply; i++)
+	{
+		if (position.GetMoves()[m_RootMoveCount + i] != m_PrincipalVariation[i])
+			return;
+	}
+
+	MoveList<MaxMoves>::iterator searchIt = std::find(moves.begin(), moves.end(), m_PrincipalVariation[ply]);
+	if (searchIt != moves.end())
+		std::rotate(moves.begin(), searchIt, searchIt + 1);
+}
+
+Move MoveMaker::GetPreviousMove(const Position& position)
+{
+	Move previousMove;
+	if (position.GetMoves().empty())
+		previousMove.SetNullMove();
+	else
+		previousMove = position.GetMoves().back();
+
+	return previousMove;
+}
+
 size_t MoveMaker::GetTranspositionTableKey(const Position& position) const
 {
 	return (position.GetZobristHash() % m_TranspositionTable.size());
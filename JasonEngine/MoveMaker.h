@@ -5,7 +5,22 @@
 #include "PositionEvaluation.h"
 #include "MoveSearcher.h"
 #include "TranspositionTable.h"
+#include "MoveHistory.h"
 #include "TimeManager.h"
+#include "SearchParameters.h"
+#include "PolyglotBook.h"
+#include <functional>
+#include <random>
+
+/// <summary>Result of a completed iterative deepening iteration, for reporting</summary>
+struct SearchInfo
+{
+	int m_Depth = 0;
+	int m_Score = 0; //score for side to move, in centipawns
+	uint64_t m_NodeCount = 0;
+	double m_Time = 0.0; //time spent since search start, in seconds
+	const MoveList<MaxPvLength>* m_PrincipalVariation = nullptr;
+};
 
 class MoveMaker
 {
@@ -16,6 +31,7 @@ public:
 	/// <param name="increment">time increment per move, for time management</param>
 	/// <param name="maxDepth">Maximum evaluation depth</param>
 	/// <param name="score">leaf position score associated to returned best move</param>
+	/// <param name="searchDepth">depth of last completed iteration, 0 for a book move</param>
 	/// <returns>true if move was applied, false if illegal or game is already over</returns>
 	bool MakeMove(double moveTime, bool isMoveTime, double increment, Position& position, int maxDepth, int& score, int& searchDepth);
 	bool MakeMove(Position& position, int maxDepth, int& score);
@@ -27,14 +43,49 @@ public:
 	/// <param=name"ply">ply number to retrieve generated move list in m_MoveLists ; moves will be regenerated if < 0</param>
 	void CheckGameOver(Position& position, int ply = -1);
 
+	/// <summary>Set function called after every completed iteration of iterative deepening (e.g. to print uci info)</summary>
+	void SetIterationCallback(const std::function<void(const SearchInfo&)>& callback) { m_IterationCallback = callback; };
+
+	/// <returns>Principal variation of last completed iteration, first move is the best move</returns>
+	const MoveList<MaxPvLength>& GetPrincipalVariation() const { return m_PrincipalVariation; };
+
+	/// <summary>Quiescent search of position without time limit, e.g. to keep only quiet positions for tuning</summary>
+	/// <returns>Score (>0 for white advantage, <0 for black), in centipawns</returns>
+	int GetQuiescentScore(Position& position);
+
+	/// <summary>Stop searching once node limit is reached, 0 for no limit ; e.g. for fixed nodes games</summary>
+	void SetNodeLimit(uint64_t nodeLimit) { m_NodeLimit = nodeLimit; };
+
+	/// <returns>Number of nodes visited by last search, including quiescent search</returns>
+	uint64_t GetNodeCount() const { return m_NodeCount; };
+
+	/// <summary>Set search and time management parameters, used from next search</summary>
+	void SetSearchParameters(const SearchParameters& parameters);
+	const SearchParameters& GetSearchParameters() const { return m_SearchParameters; };
+
+	/// <summary>Play a book move without searching when position is in book, nullptr to always search</summary>
+	/// <remark>Book is not owned and has to outlive its use</remark>
+	void SetBook(const PolyglotBook* book) { m_Book = book; };
+
+	/// <summary>Use transposition table of another move maker, so that concurrent searches benefit from each other's results</summary>
+	void ShareTranspositionTable(const MoveMaker& moveMaker) { m_TranspositionTable.Share(moveMaker.m_TranspositionTable); };
+
 protected: //protected for testing
+	/// <summary>Compare moves as SortMoves does, quiet moves keys are computed on each call</summary>
 	bool MovesSorter(const Position& position, int ply, const Move& move1, const Move& move2);
+	/// <param name="quietKey1">sort key of move1 if quiet, see GetQuietMoveKey</param>
+	bool MovesSorter(const Position& position, int ply, const Move& move1, const Move& move2, int quietKey1, int quietKey2) const;
 	void SortMoves(const Position& position, int ply, MoveList<MaxMoves>& moves);
+
+	/// <returns>Sort key of a quiet move, countermove first then history score</returns>
+	int GetQuietMoveKey(const Move& move, const Move& previousMove, const Move& counterMove, bool isWhite) const;
 	
 	TranspositionTable m_TranspositionTable; //simple transposition table, store scores of positions evaluated at depth 0 to, key is Zobrist hash % size
 
 	size_t GetTranspositionTableKey(const Position& position) const;
 
+	MoveHistory m_MoveHistory; //history, countermove and continuation history heuristics for quiet moves
+
 private:
 	/// <returns>True if move found, false if StaleMate</returns>
 	/// <param=name"maxDepth">max evaluation depth</param>
@@ -49,12 +100,37 @@ private:
 	/// <summary>Depth limited minimax algorithm, very slow, only for testing against alpha-beta negamax</summary>
 	int Minimax(Position& position, int depth, bool maximizeWhite, std::optional<Move>& bestMove);
 
+	/// <summary>Search captures only until position is quiet, with delta and SEE pruning</summary>
 	int QuiescentSearch(Position& position, int ply, int alpha, int beta, bool maximizeWhite);
 
+	/// <summary>Transposition table lookup, alpha and beta are narrowed with stored bounds</summary>
+	/// <returns>True if stored score can be returned directly</returns>
+	bool ProbeTranspositionTable(const Position& position, int depth, int& alpha, int& beta, int& score, std::optional<Move>& bestMove);
+	void StoreTranspositionTable(const Position& position, int depth, int score, int originalAlpha, int beta, const Move& bestMove);
+
+	/// <returns>True if transposition table has a best move for position, quiescent search entries without a capture over alpha have none</returns>
+	bool HasTranspositionTableMove(const Position& position) const;
+
+	/// <summary>Store quiescent search result at depth 0, if it doesn't replace an entry from main search</summary>
+	void StoreQuiescentTranspositionTable(const Position& position, int score, int originalAlpha, int beta, const Move& bestMove);
+
 	/// <summary>Static evaluation of a position at depth 0</summary>
 	/// <returns>Score (>0 for white advantage, <0 for black), in centipawns</returns>
 	/// <param=name"ply">ply number to retrieve generated move list in m_MoveLists ; moves will be regenerated if < 0</param>
-	int EvaluatePosition(Position& position, int ply = -1);
+	/// <param=name"alpha">alpha-beta window from white point of view, for lazy evaluation</param>
+	int EvaluatePosition(Position& position, int ply = -1, int alpha = -Mate, int beta = Mate);
+
+	/// <returns>True if search must stop because of time or node limit</returns>
+	bool IsSearchStopped();
+
+	/// <summary>Principal variation at ply is move followed by principal variation at ply + 1</summary>
+	void UpdatePrincipalVariation(int ply, const Move& move);
+
+	/// <summary>Put move of previous iteration principal variation first, if position is on it</summary>
+	void SortPrincipalVariationMove(const Position& position, int ply, MoveList<MaxMoves>& moves);
+
+	/// <returns>Last move played to reach position, null move if none</returns>
+	static Move GetPreviousMove(const Position& position);
 
 	std::array<std::array<Move, NbOfKillerMoves>, MaxPly> m_KillerMoves = {};
 
@@ -62,4 +138,20 @@ private:
 	std::array<MoveList<MaxMoves>, MaxPly> m_MoveLists = {};
 
 	TimeManager m_TimeManager;
+
+	///<summary>Triangular table, principal variation found at each ply of current iteration</summary>
+	std::array<MoveList<MaxPvLength>, MaxPvLength> m_PrincipalVariationTable = {};
+	MoveList<MaxPvLength> m_PrincipalVariation; //principal variation of last completed iteration
+	size_t m_RootMoveCount = 0; //number of moves played to reach root position
+
+	uint64_t m_NodeCount = 0;
+	uint64_t m_NodeLimit = 0;
+	std::function<void(const SearchInfo&)> m_IterationCallback;
+
+	const PolyglotBook* m_Book = nullptr;
+	std::mt19937 m_BookGenerator{ std::random_device{}() }; //weighted pick of book moves
+
+	SearchParameters m_SearchParameters;
+
+	friend class MoveMakerTests;
 };
\ No newline at end of file
@@ -5,10 +5,11 @@
 #include <iterator>
 #include <algorithm>
 
-static PieceType _type = PieceType::Pawn;
-static int _from = 0;
+//thread_local so that positions can be searched and evaluated in parallel
+static thread_local PieceType _type = PieceType::Pawn;
+static thread_local int _from = 0;
 //static std::vector<Move> _moves;
-static MoveList<MaxMoves>::iterator _movesIt; //SHOULD BE INSERT_ITERATOR!
+static thread_local MoveList<MaxMoves>::iterator _movesIt; //SHOULD BE INSERT_ITERATOR!
 static void MakeMove(int to);
 static void GenerateMoveList(PieceType type, int from, const Bitboard& to, MoveList<MaxMoves>& moveList)
 {
@@ -263,9 +264,9 @@ std::vector<Move> MoveSearcher::GetLegalMoves(const Position& position)
 }
 
 //static global variables, very fragile!!
-static PieceType _pieceType = PieceType::Pawn;
-static MoveList<MaxMoves>* __moves;
-static Position* _position = nullptr;
+static thread_local PieceType _pieceType = PieceType::Pawn;
+static thread_local MoveList<MaxMoves>* __moves;
+static thread_local Position* _position = nullptr;
 /// <summary> same as GetLegalMovesFromBitboards but uses static global variables </summary>
 static void _GetLegalMovesFromBitboards(int fromSquare)
 {
@@ -309,8 +310,50 @@ void MoveSearcher::GetLegalMovesFromBitboards(Position& position, MoveList<MaxMo
 	return;
 }
 
-static bool _isWhite = false;
-static Bitboard _bitboard;
+static thread_local Bitboard _toSquaresMask;
+/// <summary> same as GetLegalMovesFromBitboards with to-squares mask, but uses static global variables </summary>
+static void _GetLegalCapturesFromBitboards(int fromSquare)
+{
+	MoveSearcher::GetLegalMovesFromBitboards(*_position, _pieceType, static_cast<Square>(fromSquare), _position->IsWhiteToPlay(), _toSquaresMask, *__moves);
+}
+
+void MoveSearcher::GetLegalCapturesFromBitboards(Position& position, MoveList<MaxMoves>& legalCaptures)
+{
+	legalCaptures.clear();
+	if (position.IsRepetitionDraw())
+		return;
+
+	const bool isWhite = position.IsWhiteToPlay();
+	const Bitboard& enemyPieces = isWhite ? position.GetBlackPieces() : position.GetWhitePieces();
+	const Bitboard enPassant = (position.GetEnPassantSquare().has_value() ? Bitboard(*position.GetEnPassantSquare()) : Bitboard());
+
+	__moves = &legalCaptures;
+	_position = &position;
+
+	//only pawns can capture on en passant square
+	_toSquaresMask = enemyPieces | enPassant;
+	_pieceType = PieceType::Pawn;
+	LoopOverSetBits(position.GetPiecesOfType(PieceType::Pawn, isWhite), _GetLegalCapturesFromBitboards);
+
+	_toSquaresMask = enemyPieces;
+	_pieceType = PieceType::Knight;
+	LoopOverSetBits(position.GetPiecesOfType(PieceType::Knight, isWhite), _GetLegalCapturesFromBitboards);
+
+	_pieceType = PieceType::Rook;
+	LoopOverSetBits(position.GetPiecesOfType(PieceType::Rook, isWhite), _GetLegalCapturesFromBitboards);
+
+	_pieceType = PieceType::Bishop;
+	LoopOverSetBits(position.GetPiecesOfType(PieceType::Bishop, isWhite), _GetLegalCapturesFromBitboards);
+
+	_pieceType = PieceType::Queen;
+	LoopOverSetBits(position.GetPiecesOfType(PieceType::Queen, isWhite), _GetLegalCapturesFromBitboards);
+
+	_pieceType = PieceType::King;
+	LoopOverSetBits(position.GetPiecesOfType(PieceType::King, isWhite), _GetLegalCapturesFromBitboards);
+}
+
+static thread_local bool _isWhite = false;
+static thread_local Bitboard _bitboard;
 static void _GetPseudoLegalSquaresFromBitboards(int fromSquare)
 {
 	_bitboard |= MoveSearcher::GetPseudoLegalBitboardMoves(*_position, _pieceType, Bitboard(fromSquare), _isWhite, false);
@@ -448,9 +491,15 @@ static void MakeValidIdx(MoveList<MaxMoves>& list, size_t i)
 }
 
 void MoveSearcher::GetLegalMovesFromBitboards(Position& position, PieceType type, Square square, bool isWhitePiece, MoveList<MaxMoves>& legalMoves)
+{
+	GetLegalMovesFromBitboards(position, type, square, isWhitePiece, ~Bitboard(), legalMoves);
+}
+
+void MoveSearcher::GetLegalMovesFromBitboards(Position& position, PieceType type, Square square, bool isWhitePiece, const Bitboard& toSquaresMask, MoveList<MaxMoves>& legalMoves)
 {
 	MoveList<MaxMoves>::iterator legalMovesInsertIt = legalMoves.end();
-	GetPseudoLegalMovesFromBitboards(position, type, square, isWhitePiece, legalMoves);
+	const Bitboard toSquares = GetPseudoLegalBitboardMoves(position, type, square, isWhitePiece, false) & toSquaresMask;
+	GenerateMoveList(type, square, toSquares, legalMoves);
 	
 	if (legalMoves.end() != legalMovesInsertIt)
 	{
@@ -1084,6 +1133,107 @@ bool MoveSearcher::IsKingInCheckFromBitboards(const Position& position, bool isW
 	return false;
 }
 
+Bitboard MoveSearcher::GetAttacks(PieceType type, Square square, const Bitboard& occupancy)
+{
+	assert(type != PieceType::Pawn);
+	switch (type)
+	{
+	case PieceType::Knight:
+		return KnightMoveTable[square];
+	case PieceType::Bishop:
+		return GenerateBishopAttacks(square, occupancy);
+	case PieceType::Rook:
+		return GenerateRookAttacks(square, occupancy);
+	case PieceType::Queen:
+		return GenerateRookAttacks(square, occupancy) | GenerateBishopAttacks(square, occupancy);
+	default:
+		return KingMoveTable[square];
+	}
+}
+
+Bitboard MoveSearcher::GetAttackersTo(const Position& position, Square square, const Bitboard& occupancy)
+{
+	const Bitboard rooksAndQueens = position.GetWhiteRooks() | position.GetBlackRooks() | position.GetWhiteQueens() | position.GetBlackQueens();
+	const Bitboard bishopsAndQueens = position.GetWhiteBishops() | position.GetBlackBishops() | position.GetWhiteQueens() | position.GetBlackQueens();
+
+	//attack squares of a "super piece" placed on square, crossed with pieces positions
+	Bitboard attackers = (BlackPawnCaptureMoveTable[square] & position.GetWhitePawns()) |
+		(WhitePawnCaptureMoveTable[square] & position.GetBlackPawns()) |
+		(KnightMoveTable[square] & (position.GetWhiteKnights() | position.GetBlackKnights())) |
+		(KingMoveTable[square] & (position.GetWhiteKing() | position.GetBlackKing()));
+
+	if (rooksAndQueens & RookMoveTable[square])
+		attackers |= GenerateRookAttacks(square, occupancy) & rooksAndQueens;
+	if (bishopsAndQueens & BishopMoveTable[square])
+		attackers |= GenerateBishopAttacks(square, occupancy) & bishopsAndQueens;
+
+	return attackers & occupancy;
+}
+
+/// <summary>Piece values used for static exchange evaluation, King can't be exchanged</summary>
+static constexpr std::array<int, 6> ExchangeValues = { 100, 300, 300, 500, 900, 20000 };
+
+int MoveSearcher::StaticExchangeEvaluation(const Position& position, const Move& move)
+{
+	const Square toSquare = move.GetToSquare();
+	const bool isEnPassant = (move.GetFromType() == PieceType::Pawn) && position.GetEnPassantSquare().has_value() && (*position.GetEnPassantSquare() == toSquare);
+
+	//gain[d] is material balance for side to move at depth d if exchange stops there
+	std::array<int, 32> gain = {};
+	int depth = 0;
+	if (isEnPassant)
+		gain[0] = ExchangeValues[static_cast<int>(PieceType::Pawn)];
+	else
+	{
+		for (int type = static_cast<int>(PieceType::Pawn); type <= static_cast<int>(PieceType::Queen); type++)
+		{
+			if (position.GetPiecesOfType(static_cast<PieceType>(type), !position.IsWhiteToPlay()) & Bitboard(toSquare))
+			{
+				gain[0] = ExchangeValues[type];
+				break;
+			}
+		}
+	}
+
+	Bitboard occupancy = position.GetWhitePieces() | position.GetBlackPieces();
+	if (isEnPassant)
+		occupancy ^= Bitboard(position.IsWhiteToPlay() ? toSquare - 8 : toSquare + 8);
+
+	Square fromSquare = move.GetFromSquare();
+	PieceType attackerType = move.GetFromType();
+	bool isWhite = position.IsWhiteToPlay();
+	while (depth < static_cast<int>(gain.size()) - 1)
+	{
+		depth++;
+		gain[depth] = ExchangeValues[static_cast<int>(attackerType)] - gain[depth - 1]; //speculative, if attacker gets captured
+
+		occupancy ^= Bitboard(fromSquare);
+		isWhite = !isWhite;
+
+		//find least valuable attacker, recomputed so that x-ray attackers behind removed pieces are taken into account
+		const Bitboard attackers = GetAttackersTo(position, toSquare, occupancy) & (isWhite ? position.GetWhitePieces() : position.GetBlackPieces());
+		if (!attackers)
+			break;
+
+		for (int type = static_cast<int>(PieceType::Pawn); type <= static_cast<int>(PieceType::King); type++)
+		{
+			const Bitboard typeAttackers = attackers & position.GetPiecesOfType(static_cast<PieceType>(type), isWhite);
+			if (typeAttackers)
+			{
+				attackerType = static_cast<PieceType>(type);
+				fromSquare = static_cast<Square>(typeAttackers.GetSquare());
+				break;
+			}
+		}
+	}
+
+	//negamax the gains back to the root
+	while (--depth)
+		gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+
+	return gain[0];
+}
+
 std::optional<Move> MoveSearcher::GetRandomMove(const Position& position)
 {
 	std::optional<Move> move;
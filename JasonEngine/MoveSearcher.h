@@ -13,6 +13,13 @@ public:
 	/// <param name="legalMoves">move list where new moves will be appended</param>
 	static void GetLegalMovesFromBitboards(Position& position, PieceType type, Square square, bool isWhitePiece, MoveList<MaxMoves>& legalMoves);
 
+	/// <summary>Returns legal moves for ONE piece, restricted to given to-squares</summary>
+	/// <param name="toSquaresMask">only moves to these squares are generated</param>
+	static void GetLegalMovesFromBitboards(Position& position, PieceType type, Square square, bool isWhitePiece, const Bitboard& toSquaresMask, MoveList<MaxMoves>& legalMoves);
+
+	/// <returns>All legal captures (including en passant and capturing promotions) for a given position, for quiescence search</returns>
+	static void GetLegalCapturesFromBitboards(Position& position, MoveList<MaxMoves>& legalCaptures);
+
 	/// <summary>Returns Bitboard of accessible pseudo-legal squares, used for controlled squares enumeration</summary>
 	/// <param name="pawnAttackSquares">if true will return only pawn attack squares without checking enemy presence ("controlled squares")</param>
 	static Bitboard GetPseudoLegalSquaresFromBitboards(Position& position, bool isWhite, bool pawnControlledSquares);
@@ -35,6 +42,16 @@ public:
 
 	static bool IsKingInCheckFromBitboards(const Position& position, bool isWhiteKing);
 
+	/// <returns>Squares attacked by a piece (not a pawn) on square, including squares of pieces of both colors</returns>
+	static Bitboard GetAttacks(PieceType type, Square square, const Bitboard& occupancy);
+
+	/// <returns>Pieces of both colors attacking square, sliding attacks are computed with given occupancy (for x-rays)</returns>
+	static Bitboard GetAttackersTo(const Position& position, Square square, const Bitboard& occupancy);
+
+	/// <summary>Static exchange evaluation: resolves the sequence of captures on move's to-square, least valuable attacker first</summary>
+	/// <returns>Material balance in centipawns for side making the move, negative if move loses material</returns>
+	static int StaticExchangeEvaluation(const Position& position, const Move& move);
+
 	/// <summary>Returns a random legal move from a given position (null if stalemate or checkmate)</summary>
 	static std::optional<Move> GetRandomMove(const Position& position);
 	static std::optional<Move> GetRandomMoveFromBitboards(Position& position);
@@ -0,0 +1,236 @@
+#include "pch.h"
+#include "NeuralNetwork.h"
+#include "NeuralNetworkKernels.h"
+#include "Position.h"
+#include <fstream>
+#include <algorithm>
+#include <assert.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define USE_AVX2
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define USE_AVX2
+#endif
+
+//Vector kernels, AVX2 kernels are in NeuralNetworkAvx2.cpp
+
+static void AddWeightsScalar(int16_t* values, const int16_t* weights, int size)
+{
+	for (int i = 0; i < size; i++)
+		values[i] += weights[i];
+}
+
+static void SubtractWeightsScalar(int16_t* values, const int16_t* weights, int size)
+{
+	for (int i = 0; i < size; i++)
+		values[i] -= weights[i];
+}
+
+static int ClippedReluDotProductScalar(const int16_t* values, const int16_t* weights, int size, int16_t max)
+{
+	int sum = 0;
+	for (int i = 0; i < size; i++)
+		sum += std::clamp<int>(values[i], 0, max) * weights[i];
+	return sum;
+}
+
+static const NeuralNetworkKernels ScalarKernels = { AddWeightsScalar, SubtractWeightsScalar, ClippedReluDotProductScalar };
+
+#if defined(USE_SSE2)
+static void AddWeightsSse2(int16_t* values, const int16_t* weights, int size)
+{
+	for (int i = 0; i < size; i += 8)
+	{
+		const __m128i sum = _mm_add_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(values + i)), _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(values + i), sum);
+	}
+}
+
+static void SubtractWeightsSse2(int16_t* values, const int16_t* weights, int size)
+{
+	for (int i = 0; i < size; i += 8)
+	{
+		const __m128i difference = _mm_sub_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(values + i)), _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(values + i), difference);
+	}
+}
+
+static int ClippedReluDotProductSse2(const int16_t* values, const int16_t* weights, int size, int16_t max)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i maxValue = _mm_set1_epi16(max);
+	__m128i sum = _mm_setzero_si128();
+	for (int i = 0; i < size; i += 8)
+	{
+		const __m128i value = _mm_min_epi16(_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(values + i)), zero), maxValue);
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(value, _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i))));
+	}
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+static const NeuralNetworkKernels Sse2Kernels = { AddWeightsSse2, SubtractWeightsSse2, ClippedReluDotProductSse2 };
+#endif
+
+/// <returns>True if CPU and operating system support AVX2</returns>
+static bool IsAvx2Supported()
+{
+#if defined(USE_AVX2) && defined(_MSC_VER)
+	std::array<int, 4> registers = {};
+	__cpuid(registers.data(), 0);
+	if (registers[0] < 7)
+		return false;
+
+	//AVX registers must be saved by operating system
+	__cpuid(registers.data(), 1);
+	const bool hasOsSave = (registers[2] & (1 << 27)) != 0;
+	const bool hasAvx = (registers[2] & (1 << 28)) != 0;
+	if (!hasOsSave || !hasAvx || ((_xgetbv(0) & 0x6) != 0x6))
+		return false;
+
+	__cpuidex(registers.data(), 7, 0);
+	return (registers[1] & (1 << 5)) != 0;
+#elif defined(USE_AVX2)
+	__builtin_cpu_init(); //may be called by static initialization
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+std::unique_ptr<NeuralNetwork::Parameters> NeuralNetwork::Network;
+bool NeuralNetwork::Use = false;
+NeuralNetwork::InstructionSet NeuralNetwork::Instructions = NeuralNetwork::GetBestInstructionSet();
+const NeuralNetworkKernels* NeuralNetwork::Kernels = NeuralNetwork::GetKernels(NeuralNetwork::Instructions);
+
+bool NeuralNetwork::IsSupported(InstructionSet instructionSet)
+{
+	return GetKernels(instructionSet) != nullptr;
+}
+
+bool NeuralNetwork::SetInstructionSet(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+		return false;
+
+	Instructions = instructionSet;
+	Kernels = GetKernels(instructionSet);
+	return true;
+}
+
+NeuralNetwork::InstructionSet NeuralNetwork::GetBestInstructionSet()
+{
+	for (InstructionSet instructionSet : { InstructionSet::Avx2, InstructionSet::Sse2 })
+	{
+		if (IsSupported(instructionSet))
+			return instructionSet;
+	}
+
+	return InstructionSet::Scalar;
+}
+
+const NeuralNetworkKernels* NeuralNetwork::GetKernels(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+	case InstructionSet::Scalar:
+		return &ScalarKernels;
+#if defined(USE_SSE2)
+	case InstructionSet::Sse2:
+		return &Sse2Kernels;
+#endif
+#if defined(USE_AVX2)
+	case InstructionSet::Avx2:
+		return IsAvx2Supported() ? &Avx2Kernels : nullptr;
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+bool NeuralNetwork::Load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	return Load(file);
+}
+
+bool NeuralNetwork::Load(std::istream& stream)
+{
+	std::array<char, 4> magic = {};
+	uint32_t hiddenSize = 0;
+	stream.read(magic.data(), magic.size());
+	stream.read(reinterpret_cast<char*>(&hiddenSize), sizeof(hiddenSize));
+	if (!stream || std::string(magic.data(), magic.size()) != "JNN1" || hiddenSize != HiddenSize)
+		return false;
+
+	std::unique_ptr<Parameters> network(new Parameters);
+	stream.read(reinterpret_cast<char*>(network->m_InputWeights.data()), sizeof(network->m_InputWeights));
+	stream.read(reinterpret_cast<char*>(network->m_HiddenBiases.data()), sizeof(network->m_HiddenBiases));
+	stream.read(reinterpret_cast<char*>(network->m_OutputWeights.data()), sizeof(network->m_OutputWeights));
+	stream.read(reinterpret_cast<char*>(&network->m_OutputBias), sizeof(network->m_OutputBias));
+	if (!stream)
+		return false;
+
+	Network = std::move(network);
+	return true;
+}
+
+void NeuralNetwork::Unload()
+{
+	Network.reset();
+}
+
+void NeuralNetwork::ResetAccumulator(Accumulator& accumulator)
+{
+	assert(IsLoaded());
+	accumulator.m_White = Network->m_HiddenBiases;
+	accumulator.m_Black = Network->m_HiddenBiases;
+}
+
+void NeuralNetwork::AddPiece(Accumulator& accumulator, PieceType type, Square square, bool isWhite)
+{
+	Kernels->m_AddWeights(accumulator.m_White.data(), Network->m_InputWeights[GetInputIndex(type, square, isWhite, true)].data(), HiddenSize);
+	Kernels->m_AddWeights(accumulator.m_Black.data(), Network->m_InputWeights[GetInputIndex(type, square, isWhite, false)].data(), HiddenSize);
+}
+
+void NeuralNetwork::RemovePiece(Accumulator& accumulator, PieceType type, Square square, bool isWhite)
+{
+	Kernels->m_SubtractWeights(accumulator.m_White.data(), Network->m_InputWeights[GetInputIndex(type, square, isWhite, true)].data(), HiddenSize);
+	Kernels->m_SubtractWeights(accumulator.m_Black.data(), Network->m_InputWeights[GetInputIndex(type, square, isWhite, false)].data(), HiddenSize);
+}
+
+int NeuralNetwork::Evaluate(const Position& position)
+{
+	assert(IsLoaded());
+	const Accumulator& accumulator = position.GetAccumulator();
+	const bool isWhiteToPlay = position.IsWhiteToPlay();
+	const std::array<int16_t, HiddenSize>& sideToMove = (isWhiteToPlay ? accumulator.m_White : accumulator.m_Black);
+	const std::array<int16_t, HiddenSize>& otherSide = (isWhiteToPlay ? accumulator.m_Black : accumulator.m_White);
+
+	int output = Network->m_OutputBias;
+	output += Kernels->m_ClippedReluDotProduct(sideToMove.data(), Network->m_OutputWeights.data(), HiddenSize, QuantizationA);
+	output += Kernels->m_ClippedReluDotProduct(otherSide.data(), Network->m_OutputWeights.data() + HiddenSize, HiddenSize, QuantizationA);
+
+	//output bias is scaled by QuantizationA * QuantizationB, like products of activations with output weights
+	int score = static_cast<int>(static_cast<int64_t>(output) * OutputScale / (QuantizationA * QuantizationB));
+	score = std::clamp(score, -(Mate - MaxPly - 1), Mate - MaxPly - 1); //never mistaken for a mate score
+	return isWhiteToPlay ? score : -score;
+}
+
+int NeuralNetwork::GetInputIndex(PieceType type, Square square, bool isWhite, bool isWhitePerspective)
+{
+	//own pieces first, squares are mirrored vertically for black
+	const int colorIdx = (isWhite == isWhitePerspective) ? 0 : 1;
+	const int squareIdx = isWhitePerspective ? square : (square ^ 56);
+	return colorIdx * 6 * 64 + static_cast<int>(type) * 64 + squareIdx;
+}
\ No newline at end of file
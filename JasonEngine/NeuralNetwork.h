@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <array>
+#include <memory>
+#include <string>
+#include <istream>
+#include "BasicDefinitions.h"
+
+class Position;
+struct NeuralNetworkKernels;
+
+/// <summary>
+/// Utility class for an efficiently updatable neural network evaluation: 768 inputs -> 2 x 256 hidden (clipped ReLU) -> 1 output
+/// </summary>
+/// <remark>Inputs are piece type, color and square seen from each side ; hidden layer is kept up to date by Position in an accumulator</remark>
+class NeuralNetwork
+{
+public:
+	static constexpr int InputSize = 768; //2 colors * 6 piece types * 64 squares
+	static constexpr int HiddenSize = 256;
+
+	/// <summary>Hidden layer values (before activation) seen from white and from black</summary>
+	struct Accumulator
+	{
+		alignas(32) std::array<int16_t, HiddenSize> m_White = {};
+		alignas(32) std::array<int16_t, HiddenSize> m_Black = {};
+	};
+
+	/// <summary>Load network from file</summary>
+	/// <returns>False if file can't be read or has wrong format, previous network is kept</returns>
+	static bool Load(const std::string& path);
+
+	/// <remark>Format: "JNN1", hidden size as uint32, then little endian int16: input weights [768][256], hidden biases [256], output weights [512], output bias</remark>
+	static bool Load(std::istream& stream);
+	static void Unload();
+	static bool IsLoaded() { return Network != nullptr; };
+
+	/// <summary>Use network instead of hand crafted evaluation, if a network is loaded</summary>
+	static void SetUse(bool use) { Use = use; };
+	static bool IsUsed() { return Use && IsLoaded(); };
+
+	/// <summary>Set accumulator to hidden biases, i.e. an empty board</summary>
+	static void ResetAccumulator(Accumulator& accumulator);
+	static void AddPiece(Accumulator& accumulator, PieceType type, Square square, bool isWhite);
+	static void RemovePiece(Accumulator& accumulator, PieceType type, Square square, bool isWhite);
+
+	/// <returns>Score (>0 for white advantage, <0 for black), in centipawns</returns>
+	static int Evaluate(const Position& position);
+
+	/// <summary>Instruction sets of vector kernels, scalar kernels are the reference</summary>
+	enum class InstructionSet { Scalar, Sse2, Avx2 };
+
+	/// <summary>Select vector kernels, the best instruction set supported by CPU is selected at startup</summary>
+	/// <returns>False if CPU doesn't support instruction set, previous kernels are kept</returns>
+	static bool SetInstructionSet(InstructionSet instructionSet);
+	static InstructionSet GetInstructionSet() { return Instructions; };
+	static bool IsSupported(InstructionSet instructionSet);
+
+private:
+	static constexpr int QuantizationA = 255; //hidden layer scale, activation is clipped to [0, QuantizationA]
+	static constexpr int QuantizationB = 64; //output weights scale
+	static constexpr int OutputScale = 400; //network output to centipawns
+
+	struct Parameters
+	{
+		alignas(32) std::array<std::array<int16_t, HiddenSize>, InputSize> m_InputWeights = {};
+		alignas(32) std::array<int16_t, HiddenSize> m_HiddenBiases = {};
+		alignas(32) std::array<int16_t, 2 * HiddenSize> m_OutputWeights = {}; //side to move first, then other side
+		int16_t m_OutputBias = 0;
+	};
+
+	/// <returns>Input index of piece seen from white or from black</returns>
+	static int GetInputIndex(PieceType type, Square square, bool isWhite, bool isWhitePerspective);
+
+	static InstructionSet GetBestInstructionSet();
+
+	/// <returns>Kernels for instruction set, nullptr if not supported by build or CPU</returns>
+	static const NeuralNetworkKernels* GetKernels(InstructionSet instructionSet);
+
+	static std::unique_ptr<Parameters> Network;
+	static bool Use;
+	static InstructionSet Instructions;
+	static const NeuralNetworkKernels* Kernels;
+};
\ No newline at end of file
@@ -0,0 +1,39 @@
+//compiled for AVX2 without precompiled header: only includes headers without inline code shared with other translation units
+#include "NeuralNetworkKernels.h"
+#include <immintrin.h>
+
+static void AddWeightsAvx2(int16_t* values, const int16_t* weights, int size)
+{
+	for (int i = 0; i < size; i += 16)
+	{
+		const __m256i sum = _mm256_add_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(values + i)), _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i)));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(values + i), sum);
+	}
+}
+
+static void SubtractWeightsAvx2(int16_t* values, const int16_t* weights, int size)
+{
+	for (int i = 0; i < size; i += 16)
+	{
+		const __m256i difference = _mm256_sub_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(values + i)), _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i)));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(values + i), difference);
+	}
+}
+
+static int ClippedReluDotProductAvx2(const int16_t* values, const int16_t* weights, int size, int16_t max)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i maxValue = _mm256_set1_epi16(max);
+	__m256i sum = _mm256_setzero_si256();
+	for (int i = 0; i < size; i += 16)
+	{
+		const __m256i value = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(values + i)), zero), maxValue);
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(value, _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i))));
+	}
+	__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum128);
+}
+
+const NeuralNetworkKernels Avx2Kernels = { AddWeightsAvx2, SubtractWeightsAvx2, ClippedReluDotProductAvx2 };
\ No newline at end of file
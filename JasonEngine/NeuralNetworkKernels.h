@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+/// <summary>
+/// Vector kernels of neural network evaluation for one instruction set, on int16 arrays aligned on 32 bytes with a size multiple of 16
+/// </summary>
+/// <remark>Included by translation units compiled for AVX2, so it must not define inline code, which could be shared with code run on any CPU</remark>
+struct NeuralNetworkKernels
+{
+	void (*m_AddWeights)(int16_t* values, const int16_t* weights, int size);
+	void (*m_SubtractWeights)(int16_t* values, const int16_t* weights, int size);
+	int (*m_ClippedReluDotProduct)(const int16_t* values, const int16_t* weights, int size, int16_t max); //dot product of values clipped to [0, max] with weights
+};
+
+/// <remark>Defined in NeuralNetworkAvx2.cpp, only used if CPU supports AVX2</remark>
+extern const NeuralNetworkKernels Avx2Kernels;
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "NotationParser.h"
 #include "MoveSearcher.h"
 #include <assert.h>
+#include <charconv>
+#include <algorithm>
 
 static char NthLetter(int n)
 {
@@ -43,152 +45,198 @@ static int FENIdxToSquareIdx(int fenIdx)
 
 void NotationParser::TranslateFEN(const std::string& fen, Position& position)
 {
-	position.InitEmptyBoard();
+	ParseFEN(fen, position);
+}
+
+static constexpr std::string_view PieceLetters = "PNBRQK"; //indexed by piece type, lower case for black pieces
+
+/// <returns>Next space separated field from idx, empty if none</returns>
+static std::string_view GetNextField(std::string_view fen, size_t& idx)
+{
+	while (idx < fen.size() && fen[idx] == ' ')
+		idx++;
+	const size_t begin = idx;
+	while (idx < fen.size() && fen[idx] != ' ')
+		idx++;
+	return fen.substr(begin, idx - begin);
+}
+
+static constexpr int MaxHalfMoveClock = 255; //backed up on 8 bits in Move for Undo
+static constexpr int MaxFullMoveNumber = 100000; //larger clocks would overflow game ply and ToFEN buffer
+
+/// <returns>Number in [0, max], nullopt if field is not such a number</returns>
+static std::optional<int> ParseNumber(std::string_view field, int max)
+{
+	int value = 0;
+	const std::from_chars_result result = std::from_chars(field.data(), field.data() + field.size(), value);
+	if (result.ec != std::errc() || result.ptr != field.data() + field.size() || value < 0 || value > max)
+		return std::nullopt;
 
-	//e.g.: rnbqkbnr / pppppppp / 8 / 8 / 8 / 8 / PPPPPPPP / RNBQKBNR w KQkq - 0 1
+	return value;
+}
+
+bool NotationParser::ParseFEN(std::string_view fen, Position& position)
+{
+	position.Clear();
+
+	//e.g.: rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 ; spaces are allowed between ranks
 	int fenIdx = 0; //start from top left - down to bottom right
-	int dashCount = 0;
-	std::optional<int> enPassantRow;
-	std::optional<int> enPassantFile;
-	for (char c : fen)
+	int file = 0; //within current rank, each rank must have exactly 8 squares
+	size_t idx = 0;
+	bool isValid = true;
+	for (; idx < fen.size() && fenIdx < 64 && isValid; idx++)
 	{
-		if (fenIdx < 64)
+		const unsigned char c = static_cast<unsigned char>(fen[idx]);
+		if (c >= '1' && c <= '8')
+		{
+			file += c - '0';
+			fenIdx += c - '0';
+			isValid = (file <= 8);
+		}
+		else if (c == '/')
+		{
+			isValid = (file == 8);
+			file = 0;
+		}
+		else if (c != ' ')
 		{
-			if (isalpha(c))
+			const bool isWhite = (isupper(c) != 0);
+			const size_t type = PieceLetters.find(static_cast<char>(toupper(c)));
+			isValid = (type != std::string_view::npos) && (file < 8);
+			file++;
+			if (isValid)
 			{
 				const int squareIdx = FENIdxToSquareIdx(fenIdx);
-				if (c == 'r')
-				{
-					position.GetBlackRooks() |= Bitboard(squareIdx);
-					position.GetBlackPiecesList().emplace_back(Piece(PieceType::Rook, squareIdx));
-				}
-				else if (c == 'n')
-				{
-					position.GetBlackKnights() |= Bitboard(squareIdx);
-					position.GetBlackPiecesList().emplace_back(Piece(PieceType::Knight, squareIdx));
-				}
-				else if (c == 'b')
-				{
-					position.GetBlackBishops() |= Bitboard(squareIdx);
-					position.GetBlackPiecesList().emplace_back(Piece(PieceType::Bishop, squareIdx));
-				}
-				else if (c == 'q')
-				{
-					position.GetBlackQueens() |= Bitboard(squareIdx);
-					position.GetBlackPiecesList().emplace_back(Piece(PieceType::Queen, squareIdx));
-				}
-				else if (c == 'k')
-				{
-					position.GetBlackKing() |= Bitboard(squareIdx);
-					position.GetBlackPiecesList().emplace_back(Piece(PieceType::King, squareIdx));
-				}
-				else if (c == 'p')
-				{
-					position.GetBlackPawns() |= Bitboard(squareIdx);
-					position.GetBlackPiecesList().emplace_back(Piece(PieceType::Pawn, squareIdx));
-				}
-				else if (c == 'R')
-				{
-					position.GetWhiteRooks() |= Bitboard(squareIdx);
-					position.GetWhitePiecesList().emplace_back(Piece(PieceType::Rook, squareIdx));
-				}
-				else if (c == 'N')
-				{
-					position.GetWhiteKnights() |= Bitboard(squareIdx);
-					position.GetWhitePiecesList().emplace_back(Piece(PieceType::Knight, squareIdx));
-				}
-				else if (c == 'B')
-				{
-					position.GetWhiteBishops() |= Bitboard(squareIdx);
-					position.GetWhitePiecesList().emplace_back(Piece(PieceType::Bishop, squareIdx));
-				}
-				else if (c == 'Q')
-				{
-					position.GetWhiteQueens() |= Bitboard(squareIdx);
-					position.GetWhitePiecesList().emplace_back(Piece(PieceType::Queen, squareIdx));
-				}
-				else if (c == 'K')
-				{
-					position.GetWhiteKing() |= Bitboard(squareIdx);
-					position.GetWhitePiecesList().emplace_back(Piece(PieceType::King, squareIdx));
-				}
-				else if (c == 'P')
-				{
-					position.GetWhitePawns() |= Bitboard(squareIdx);
-					position.GetWhitePiecesList().emplace_back(Piece(PieceType::Pawn, squareIdx));
-				}
-
+				position.GetPiecesOfType(static_cast<PieceType>(type), isWhite) |= Bitboard(squareIdx);
+				(isWhite ? position.GetWhitePiecesList() : position.GetBlackPiecesList()).emplace_back(Piece(static_cast<PieceType>(type), squareIdx));
 				fenIdx++;
 			}
-			else
-			{
-				if (isdigit(c))
-				{
-					fenIdx += c - '0';
-				}
-				else if (c == '//')
-				{
-					//do nothing
-				}
-			}
 		}
+	}
+	isValid = isValid && (fenIdx == 64);
+
+	const std::string_view sideToPlay = GetNextField(fen, idx);
+	isValid = isValid && (sideToPlay == "w" || sideToPlay == "b");
+	if (isValid)
+		position.SetWhiteToPlay(sideToPlay == "w");
+	position.SetFullMoveNumber(1);
+
+	const std::string_view castlingRights = GetNextField(fen, idx);
+	for (char c : castlingRights)
+	{
+		if (!isValid)
+			break;
+		else if (c == 'K')
+			position.SetCanWhiteCastleKingSide(true);
+		else if (c == 'Q')
+			position.SetCanWhiteCastleQueenSide(true);
+		else if (c == 'k')
+			position.SetCanBlackCastleKingSide(true);
+		else if (c == 'q')
+			position.SetCanBlackCastleQueenSide(true);
 		else
+			isValid = (c == '-');
+	}
+
+	const std::string_view enPassantSquare = GetNextField(fen, idx);
+	if (isValid && enPassantSquare.size() == 2 && LetterToNumber(enPassantSquare[0]) >= 0 && enPassantSquare[1] >= '1' && enPassantSquare[1] <= '8')
+		position.SetEnPassantSquare(static_cast<Square>(LetterToNumber(enPassantSquare[0]) + 8 * (enPassantSquare[1] - '1')));
+	else
+		isValid = isValid && (enPassantSquare.empty() || enPassantSquare == "-");
+
+	//move clocks
+	const std::string_view halfMoveClock = GetNextField(fen, idx);
+	const std::string_view fullMoveNumber = GetNextField(fen, idx);
+	if (isValid && !halfMoveClock.empty())
+	{
+		const std::optional<int> plies = ParseNumber(halfMoveClock, MaxHalfMoveClock);
+		const std::optional<int> fullMoves = fullMoveNumber.empty() ? 1 : ParseNumber(fullMoveNumber, MaxFullMoveNumber);
+		isValid = plies.has_value() && fullMoves.has_value();
+		if (isValid)
 		{
-			if (c == 'w')
-			{
-				position.SetWhiteToPlay(true);
-			}
-			else if (c == 'b')
-			{
-				position.SetWhiteToPlay(false);
-			}
-			else if (c == 'K')
-			{
-				position.SetCanWhiteCastleKingSide(true);
-			}
-			else if (c == 'Q')
-			{
-				position.SetCanWhiteCastleQueenSide(true);
-			}
-			else if (c == 'k')
-			{
-				position.SetCanBlackCastleKingSide(true);
-			}
-			else if (c == 'q')
-			{
-				position.SetCanBlackCastleQueenSide(true);
-			}
-			else if (c == '-') //no castling or en passant
-			{
-				dashCount++;
-			}
-			else if (isalpha(c)) //en passant file
-			{
-				enPassantFile = LetterToNumber(c);
-			}
-			else if (isdigit(c) && enPassantFile.has_value() && !enPassantRow.has_value()) //en passant row 
+			position.SetPliesFromLastIrreversibleMove(*plies);
+			position.SetFullMoveNumber(std::max(1, *fullMoves));
+		}
+	}
+
+	position.InitFromBitboards();
+	return isValid;
+}
+
+std::string_view NotationParser::ToFEN(const Position& position, std::array<char, MaxFENLength>& buffer)
+{
+	std::array<char, 64> squares;
+	squares.fill(0);
+	for (bool isWhite : { true, false })
+	{
+		for (int type = 0; type < 6; type++)
+		{
+			uint64_t bitset = position.GetPiecesOfType(static_cast<PieceType>(type), isWhite);
+			while (bitset != 0)
 			{
-				enPassantRow = (c - '0') - 1; //0 based
+				squares[_tzcnt_u64(bitset)] = isWhite ? PieceLetters[type] : static_cast<char>(PieceLetters[type] - 'A' + 'a');
+				bitset &= bitset - 1;
 			}
-			else if (isdigit(c))
+		}
+	}
+
+	char* out = buffer.data();
+	for (int rank = 7; rank >= 0; rank--)
+	{
+		int emptyCount = 0;
+		for (int file = 0; file < 8; file++)
+		{
+			const char piece = squares[file + 8 * rank];
+			if (piece == 0)
 			{
-				//move clocks
+				emptyCount++;
+				continue;
 			}
+
+			if (emptyCount > 0)
+				*out++ = static_cast<char>('0' + emptyCount);
+			emptyCount = 0;
+			*out++ = piece;
 		}
+
+		if (emptyCount > 0)
+			*out++ = static_cast<char>('0' + emptyCount);
+		if (rank > 0)
+			*out++ = '/';
 	}
 
-	if (enPassantFile.has_value() && enPassantRow.has_value())
+	*out++ = ' ';
+	*out++ = position.IsWhiteToPlay() ? 'w' : 'b';
+	*out++ = ' ';
+
+	const char* castlingRights = out;
+	if (position.CanWhiteCastleKingSide())
+		*out++ = 'K';
+	if (position.CanWhiteCastleQueenSide())
+		*out++ = 'Q';
+	if (position.CanBlackCastleKingSide())
+		*out++ = 'k';
+	if (position.CanBlackCastleQueenSide())
+		*out++ = 'q';
+	if (out == castlingRights)
+		*out++ = '-';
+	*out++ = ' ';
+
+	if (position.GetEnPassantSquare().has_value())
 	{
-		position.SetEnPassantSquare(static_cast<Square>(*enPassantFile + 8*(*enPassantRow)));
+		*out++ = NthLetter(*position.GetEnPassantSquare() % 8);
+		*out++ = static_cast<char>('1' + *position.GetEnPassantSquare() / 8);
 	}
+	else
+		*out++ = '-';
 
-	position.GetBlackPieces() = position.GetBlackPawns() | position.GetBlackKnights() | position.GetBlackBishops() |
-		position.GetBlackRooks() | position.GetBlackQueens() | position.GetBlackKing();
-	position.GetWhitePieces() = position.GetWhitePawns() | position.GetWhiteKnights() | position.GetWhiteBishops() |
-		position.GetWhiteRooks() | position.GetWhiteQueens() | position.GetWhiteKing();
+	char* const end = buffer.data() + buffer.size();
+	*out++ = ' ';
+	out = std::to_chars(out, end, position.GetPliesFromLastIrreversibleMove()).ptr;
+	*out++ = ' ';
+	out = std::to_chars(out, end, position.GetFullMoveNumber()).ptr;
 
-	position.SetZobristHash(position.ComputeZobristHash());
-	position.CommitToHistory();
+	return std::string_view(buffer.data(), out - buffer.data());
 }
 
 std::string NotationParser::TranslateToAlgebraic(PieceType type)
@@ -600,6 +648,85 @@ std::optional<Move> NotationParser::TranslateFromAlgebraic(const Position& posit
 	return move;
 }
 
+std::optional<Move> NotationParser::TranslateFromSAN(Position& position, std::string_view san)
+{
+	//check, mate and annotation suffixes
+	while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+		san.remove_suffix(1);
+
+	const bool isWhite = position.IsWhiteToPlay();
+	PieceType type = PieceType::Pawn;
+	std::optional<PieceType> promotionType;
+	std::optional<int> fromFile;
+	std::optional<int> fromRow;
+	Square to = a1;
+	if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
+	{
+		type = PieceType::King;
+		fromFile = 4;
+		fromRow = isWhite ? 0 : 7;
+		to = static_cast<Square>((san.size() == 3 ? 6 : 2) + 8 * (*fromRow));
+	}
+	else
+	{
+		if (!san.empty() && PieceLetters.find(san.front()) != std::string_view::npos && san.front() != 'P')
+		{
+			type = static_cast<PieceType>(PieceLetters.find(san.front()));
+			san.remove_prefix(1);
+		}
+
+		//promotion, e.g. e8=Q or e8Q
+		if (type == PieceType::Pawn && san.size() >= 3 && PieceLetters.find(san.back()) != std::string_view::npos)
+		{
+			promotionType = static_cast<PieceType>(PieceLetters.find(san.back()));
+			san.remove_suffix(1);
+			if (san.back() == '=')
+				san.remove_suffix(1);
+		}
+
+		if (san.size() < 2 || LetterToNumber(san[san.size() - 2]) < 0 || san.back() < '1' || san.back() > '8')
+			return std::nullopt;
+		to = static_cast<Square>(LetterToNumber(san[san.size() - 2]) + 8 * (san.back() - '1'));
+		san.remove_suffix(2);
+
+		//disambiguation and capture
+		for (char c : san)
+		{
+			if (LetterToNumber(c) >= 0)
+				fromFile = LetterToNumber(c);
+			else if (c >= '1' && c <= '8')
+				fromRow = c - '1';
+			else if (c != 'x' && c != ':')
+				return std::nullopt;
+		}
+	}
+
+	MoveList<MaxMoves> moves;
+	uint64_t pieces = position.GetPiecesOfType(type, isWhite);
+	while (pieces != 0)
+	{
+		const Square from = static_cast<Square>(_tzcnt_u64(pieces));
+		pieces &= pieces - 1;
+		if ((fromFile.has_value() && (from % 8) != *fromFile) || (fromRow.has_value() && (from / 8) != *fromRow))
+			continue;
+
+		MoveSearcher::GetLegalMovesFromBitboards(position, type, from, isWhite, Bitboard(to), moves);
+	}
+
+	std::optional<Move> move;
+	for (const Move& legalMove : moves)
+	{
+		if (legalMove.GetToType() != promotionType.value_or(type))
+			continue;
+		if (move.has_value())
+			return std::nullopt; //ambiguous
+
+		move = legalMove;
+	}
+
+	return move;
+}
+
 std::optional<Move> NotationParser::TranslateFromUci(const Position& position, const std::string& moveString)
 {
 	return TranslateFromAlgebraic(position, moveString, true);
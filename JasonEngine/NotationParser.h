@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <array>
 #include "Position.h"
 
 class NotationParser
@@ -23,6 +25,13 @@ public:
 	/// <param name="isUciString">if true, string will be treated as a uci move (size 4 or 5 string)</param>
 	static std::optional<Move> TranslateFromAlgebraic(const Position& position, const std::string& moveString, bool isUciString = false);
 
+	/// <summary>
+	/// Translate from standard algebraic notation, with any disambiguation, captures, promotions, castling, check and annotation suffixes
+	/// </summary>
+	/// <remark>Moves are matched against legal moves, position is only modified during move generation</remark>
+	/// <returns>Move if it is legal and unambiguous, nullopt otherwise</returns>
+	static std::optional<Move> TranslateFromSAN(Position& position, std::string_view san);
+
 	/// <summary>
 	/// Translate from uci move notation (if valid move!)
 	/// </summary>
@@ -33,6 +42,21 @@ public:
 	/// </summary>
 	static void TranslateFEN(const std::string& fen, Position& position);
 
+	/// <summary>
+	/// Set position from fen notation, pieces are written directly to bitboards ; castling, en passant and move clocks fields are optional
+	/// </summary>
+	/// <remark>No heap allocation once position piece lists have reached their capacity, e.g. when a position is reused</remark>
+	/// <returns>False if a field can't be read, position is still valid with fields read so far</returns>
+	static bool ParseFEN(std::string_view fen, Position& position);
+
+	static constexpr size_t MaxFENLength = 96; //64 pieces and 7 slashes, fields and separators
+
+	/// <summary>
+	/// Write fen notation of position to buffer, full move number counts moves played since position was set
+	/// </summary>
+	/// <returns>FEN, viewing buffer</returns>
+	static std::string_view ToFEN(const Position& position, std::array<char, MaxFENLength>& buffer);
+
 private:
 
 	static std::string TranslateToAlgebraic(PieceType type);
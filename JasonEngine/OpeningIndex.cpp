@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "OpeningIndex.h"
+#include <algorithm>
+
+void OpeningIndexEntry::Merge(const OpeningIndexEntry& entry)
+{
+	m_RatingSum += entry.m_RatingSum;
+	m_WhiteWins += entry.m_WhiteWins;
+	m_Draws += entry.m_Draws;
+	m_BlackWins += entry.m_BlackWins;
+	m_RatedGameCount += entry.m_RatedGameCount;
+}
+
+OpeningIndexHeader OpeningIndexHeader::Create()
+{
+	OpeningIndexHeader header;
+	header.m_StartPositionKey = Position().GetZobristHash();
+	header.m_Version = CurrentVersion;
+	return header;
+}
+
+bool OpeningIndex::Open(const std::string& path)
+{
+	Close();
+	if (!m_File.Open(path))
+		return false;
+
+	const size_t size = m_File.size();
+	if ((size < sizeof(OpeningIndexHeader)) || !(*reinterpret_cast<const OpeningIndexHeader*>(m_File.data()) == OpeningIndexHeader::Create())
+		|| ((size - sizeof(OpeningIndexHeader)) % sizeof(OpeningIndexEntry) != 0))
+	{
+		m_File.Close();
+		return false;
+	}
+
+	m_Entries = reinterpret_cast<const OpeningIndexEntry*>(m_File.data() + sizeof(OpeningIndexHeader));
+	m_Count = (size - sizeof(OpeningIndexHeader)) / sizeof(OpeningIndexEntry);
+	return true;
+}
+
+void OpeningIndex::Close()
+{
+	m_File.Close();
+	m_Entries = nullptr;
+	m_Count = 0;
+}
+
+std::vector<OpeningIndexEntry> OpeningIndex::GetMoves(const Position& position) const
+{
+	const uint64_t key = position.GetZobristHash();
+	const OpeningIndexEntry* first = std::lower_bound(m_Entries, m_Entries + m_Count, key,
+		[](const OpeningIndexEntry& entry, uint64_t value) { return entry.m_Key < value; });
+
+	std::vector<OpeningIndexEntry> moves;
+	for (const OpeningIndexEntry* entry = first; entry != m_Entries + m_Count && entry->m_Key == key; entry++)
+		moves.push_back(*entry);
+
+	std::stable_sort(moves.begin(), moves.end(), [](const OpeningIndexEntry& entry1, const OpeningIndexEntry& entry2)
+		{ return entry1.GetGameCount() > entry2.GetGameCount(); });
+	return moves;
+}
\ No newline at end of file
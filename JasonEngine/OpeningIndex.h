@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "Position.h"
+#include "MappedFile.h"
+
+/// <summary>Statistics of a move played in a position, written as raw bytes in opening index files</summary>
+struct OpeningIndexEntry
+{
+	uint64_t m_Key = 0; //Zobrist hash of position before move
+	uint64_t m_RatingSum = 0; //sum of ratings of players who played move, in rated games
+	uint32_t m_WhiteWins = 0;
+	uint32_t m_Draws = 0;
+	uint32_t m_BlackWins = 0;
+	uint32_t m_RatedGameCount = 0;
+	uint16_t m_Move = 0; //packed as best move of packed positions
+	std::array<uint16_t, 3> m_Padding = {};
+
+	uint32_t GetGameCount() const { return m_WhiteWins + m_Draws + m_BlackWins; };
+
+	/// <returns>Average rating of players who played move, 0 if no rated game</returns>
+	int GetAverageRating() const { return (m_RatedGameCount == 0) ? 0 : static_cast<int>(m_RatingSum / m_RatedGameCount); };
+
+	/// <summary>Add statistics of an entry with same key and move</summary>
+	void Merge(const OpeningIndexEntry& entry);
+
+	/// <summary>Index order, by key then move</summary>
+	bool operator<(const OpeningIndexEntry& entry) const { return (m_Key != entry.m_Key) ? (m_Key < entry.m_Key) : (m_Move < entry.m_Move); };
+	bool IsSameMove(const OpeningIndexEntry& entry) const { return (m_Key == entry.m_Key) && (m_Move == entry.m_Move); };
+};
+static_assert(sizeof(OpeningIndexEntry) == 40, "opening index entries are written as raw bytes");
+
+/// <summary>Start of opening index files, entries follow it</summary>
+/// <remark>Entry keys are only valid for builds with same Zobrist keys, which are checked with start position hash</remark>
+struct OpeningIndexHeader
+{
+	static constexpr uint32_t CurrentVersion = 1;
+
+	uint64_t m_StartPositionKey = 0; //Zobrist hash of start position
+	uint32_t m_Version = 0;
+	uint32_t m_Padding = 0;
+
+	/// <returns>Header of files written by this build</returns>
+	static OpeningIndexHeader Create();
+	bool operator==(const OpeningIndexHeader& header) const { return (m_StartPositionKey == header.m_StartPositionKey) && (m_Version == header.m_Version); };
+};
+static_assert(sizeof(OpeningIndexHeader) == 16, "opening index header is written as raw bytes");
+
+/// <summary>
+/// Read only memory mapping of an opening index file: a header, then entries sorted by key and move, one entry per move played in a position
+/// </summary>
+/// <remark>Lookups are binary searches in place, only touched pages of the file are read</remark>
+class OpeningIndex
+{
+public:
+	/// <returns>False if file can't be mapped, has a header of another version or Zobrist keys, or has a partial entry</returns>
+	bool Open(const std::string& path);
+	void Close();
+
+	size_t size() const { return m_Count; };
+
+	/// <returns>Moves played in position, by decreasing game count</returns>
+	std::vector<OpeningIndexEntry> GetMoves(const Position& position) const;
+
+private:
+	MappedFile m_File;
+	const OpeningIndexEntry* m_Entries = nullptr;
+	size_t m_Count = 0;
+};
\ No newline at end of file
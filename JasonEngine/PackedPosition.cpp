@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "PackedPosition.h"
+#include <algorithm>
+
+static int CountSetBits(uint64_t bitset)
+{
+	int count = 0;
+	for (; bitset != 0; bitset &= bitset - 1)
+		count++;
+
+	return count;
+}
+
+std::optional<PackedPosition> PackedPosition::Pack(const Position& position)
+{
+	PackedPosition packedPosition;
+	packedPosition.m_Occupancy = position.GetWhitePieces() | position.GetBlackPieces();
+	if (CountSetBits(packedPosition.m_Occupancy) > MaxPieceCount)
+		return std::nullopt;
+
+	std::array<uint8_t, 64> codes = {};
+	for (int type = 0; type < 6; type++)
+	{
+		for (bool isWhite : { true, false })
+		{
+			uint64_t bitset = position.GetPiecesOfType(static_cast<PieceType>(type), isWhite);
+			while (bitset != 0)
+			{
+				codes[_tzcnt_u64(bitset)] = static_cast<uint8_t>(isWhite ? type : 8 + type);
+				bitset &= bitset - 1;
+			}
+		}
+	}
+
+	uint64_t occupancy = packedPosition.m_Occupancy;
+	int pieceIdx = 0;
+	while (occupancy != 0)
+	{
+		packedPosition.m_Pieces[pieceIdx / 2] |= codes[_tzcnt_u64(occupancy)] << (4 * (pieceIdx % 2));
+		occupancy &= occupancy - 1;
+		pieceIdx++;
+	}
+
+	packedPosition.m_Flags |= position.IsWhiteToPlay() ? WhiteToPlayFlag : 0;
+	packedPosition.m_Flags |= position.CanWhiteCastleKingSide() ? WhiteKingSideCastleFlag : 0;
+	packedPosition.m_Flags |= position.CanWhiteCastleQueenSide() ? WhiteQueenSideCastleFlag : 0;
+	packedPosition.m_Flags |= position.CanBlackCastleKingSide() ? BlackKingSideCastleFlag : 0;
+	packedPosition.m_Flags |= position.CanBlackCastleQueenSide() ? BlackQueenSideCastleFlag : 0;
+	packedPosition.m_EnPassantSquare = position.GetEnPassantSquare().has_value() ? static_cast<uint8_t>(*position.GetEnPassantSquare()) : NoEnPassantSquare;
+	packedPosition.m_HalfMoveClock = static_cast<uint8_t>(std::min(position.GetPliesFromLastIrreversibleMove(), 255));
+	return packedPosition;
+}
+
+bool PackedPosition::IsValid() const
+{
+	const int pieceCount = CountSetBits(m_Occupancy);
+	if (pieceCount > MaxPieceCount || m_Result > 2)
+		return false;
+
+	for (int pieceIdx = 0; pieceIdx < pieceCount; pieceIdx++)
+	{
+		const int code = (m_Pieces[pieceIdx / 2] >> (4 * (pieceIdx % 2))) & 0xF;
+		if ((code & 7) > static_cast<int>(PieceType::King))
+			return false;
+	}
+
+	return true;
+}
+
+bool PackedPosition::Unpack(Position& position) const
+{
+	position.Clear(); //reuses position storage, a copy of an empty position would copy its whole history
+	if (!IsValid())
+		return false;
+
+	uint64_t occupancy = m_Occupancy;
+	int pieceIdx = 0;
+	while (occupancy != 0)
+	{
+		const int squareIdx = static_cast<int>(_tzcnt_u64(occupancy));
+		const int code = (m_Pieces[pieceIdx / 2] >> (4 * (pieceIdx % 2))) & 0xF;
+		const bool isWhite = (code < 8);
+		const PieceType type = static_cast<PieceType>(code & 7);
+		position.GetPiecesOfType(type, isWhite) |= Bitboard(squareIdx);
+		(isWhite ? position.GetWhitePiecesList() : position.GetBlackPiecesList()).emplace_back(Piece(type, squareIdx));
+		occupancy &= occupancy - 1;
+		pieceIdx++;
+	}
+
+	position.SetWhiteToPlay((m_Flags & WhiteToPlayFlag) != 0);
+	position.SetCanWhiteCastleKingSide((m_Flags & WhiteKingSideCastleFlag) != 0);
+	position.SetCanWhiteCastleQueenSide((m_Flags & WhiteQueenSideCastleFlag) != 0);
+	position.SetCanBlackCastleKingSide((m_Flags & BlackKingSideCastleFlag) != 0);
+	position.SetCanBlackCastleQueenSide((m_Flags & BlackQueenSideCastleFlag) != 0);
+	if (m_EnPassantSquare < NoEnPassantSquare)
+		position.SetEnPassantSquare(static_cast<Square>(m_EnPassantSquare));
+	position.SetPliesFromLastIrreversibleMove(m_HalfMoveClock);
+	position.InitFromBitboards();
+	return true;
+}
+
+std::optional<Position> PackedPosition::Unpack() const
+{
+	Position position;
+	if (!Unpack(position))
+		return std::nullopt;
+
+	return position;
+}
+
+uint16_t PackedPosition::PackMove(const Move& move)
+{
+	const int promotionType = (move.GetFromType() != move.GetToType()) ? static_cast<int>(move.GetToType()) : 0;
+	return static_cast<uint16_t>(move.GetFromSquare() | (move.GetToSquare() << 6) | (promotionType << 12));
+}
+
+std::optional<Move> PackedPosition::UnpackMove(const Position& position, uint16_t packedMove)
+{
+	if (packedMove == 0)
+		return std::nullopt;
+
+	const Square from = static_cast<Square>(packedMove & 0x3f);
+	const Square to = static_cast<Square>((packedMove >> 6) & 0x3f);
+	const int promotionType = (packedMove >> 12) & 0x7;
+	for (int type = 0; type < 6; type++)
+	{
+		const PieceType fromType = static_cast<PieceType>(type);
+		if ((position.GetPiecesOfType(fromType, position.IsWhiteToPlay()) & Bitboard(from)) > 0)
+			return Move(fromType, promotionType != 0 ? static_cast<PieceType>(promotionType) : fromType, from, to);
+	}
+
+	return std::nullopt;
+}
+
+bool PackedPositionWriter::Open(const std::string& path, bool append)
+{
+	m_File.open(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+	m_Buffer.reserve(BufferSize);
+	m_Count = 0;
+	return m_File.is_open();
+}
+
+void PackedPositionWriter::Write(const PackedPosition& packedPosition)
+{
+	m_Buffer.push_back(packedPosition);
+	m_Count++;
+	if (m_Buffer.size() == BufferSize)
+		Flush();
+}
+
+void PackedPositionWriter::Flush()
+{
+	if (m_Buffer.empty())
+		return;
+
+	m_File.write(reinterpret_cast<const char*>(m_Buffer.data()), m_Buffer.size() * sizeof(PackedPosition));
+	m_File.flush();
+	m_Buffer.clear();
+}
+
+bool PackedPositionReader::Open(const std::string& path)
+{
+	if (!m_File.Open(path))
+		return false;
+
+	m_Positions = reinterpret_cast<const PackedPosition*>(m_File.data());
+	m_Count = m_File.size() / sizeof(PackedPosition);
+	return true;
+}
+
+void PackedPositionReader::Close()
+{
+	m_File.Close();
+	m_Positions = nullptr;
+	m_Count = 0;
+}
\ No newline at end of file
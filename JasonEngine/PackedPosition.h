@@ -0,0 +1,97 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdint.h>
+#include "Position.h"
+#include "MappedFile.h"
+
+/// <summary>
+/// Fixed size position encoding for training data: occupancy bitboard and 4 bits per occupied square,
+/// followed by side to play, castling rights, en passant square, half move clock, score, game result and best move
+/// </summary>
+/// <remark>Positions are written and read as raw bytes, they don't keep move history</remark>
+struct PackedPosition
+{
+	static constexpr uint8_t WhiteToPlayFlag = 1;
+	static constexpr uint8_t WhiteKingSideCastleFlag = 2;
+	static constexpr uint8_t WhiteQueenSideCastleFlag = 4;
+	static constexpr uint8_t BlackKingSideCastleFlag = 8;
+	static constexpr uint8_t BlackQueenSideCastleFlag = 16;
+	static constexpr uint8_t NoEnPassantSquare = 64;
+
+	uint64_t m_Occupancy = 0;
+	std::array<uint8_t, 16> m_Pieces = {}; //codes of occupied squares by increasing square index, 4 bits each: piece type for white pieces, 8 + piece type for black pieces
+	uint8_t m_Flags = 0; //side to play and castling rights
+	uint8_t m_EnPassantSquare = NoEnPassantSquare;
+	uint8_t m_HalfMoveClock = 0; //plies since last capture or pawn move
+	uint8_t m_Result = 1; //0 if black won, 1 if draw, 2 if white won
+	int16_t m_Score = 0; //from white point of view, in centipawns
+	uint16_t m_Move = 0; //from square on bits 0 to 5, to square on bits 6 to 11, promotion type on bits 12 to 14 ; 0 if no move
+
+	static constexpr int MaxPieceCount = 32;
+
+	/// <returns>Nullopt if position has more than 32 pieces</returns>
+	static std::optional<PackedPosition> Pack(const Position& position);
+
+	/// <returns>False if record is corrupted: more than 32 pieces, unknown piece codes or game result</returns>
+	bool IsValid() const;
+
+	/// <summary>Set position to packed position, with hashes and incremental scores, without move history</summary>
+	/// <returns>False if packed position is not valid, position is then left empty</returns>
+	bool Unpack(Position& position) const;
+	std::optional<Position> Unpack() const;
+
+	void SetMove(const Move& move) { m_Move = PackMove(move); };
+
+	/// <returns>Best move, from type is read from position ; nullopt if no move</returns>
+	std::optional<Move> GetMove(const Position& position) const { return UnpackMove(position, m_Move); };
+
+	/// <summary>Move packed in 16 bits, as best move of packed positions</summary>
+	static uint16_t PackMove(const Move& move);
+	static std::optional<Move> UnpackMove(const Position& position, uint16_t packedMove);
+};
+static_assert(sizeof(PackedPosition) == 32, "packed positions are written as raw bytes");
+
+/// <summary>Buffered writer of packed positions to a binary file</summary>
+class PackedPositionWriter
+{
+public:
+	/// <param name="append">append to existing file, otherwise file is truncated</param>
+	/// <returns>False if file can't be opened</returns>
+	bool Open(const std::string& path, bool append);
+	~PackedPositionWriter() { Flush(); };
+
+	void Write(const PackedPosition& packedPosition);
+	void Flush();
+
+	uint64_t GetCount() const { return m_Count; };
+
+private:
+	static constexpr size_t BufferSize = 1 << 15; //number of positions written at once
+
+	std::ofstream m_File;
+	std::vector<PackedPosition> m_Buffer;
+	uint64_t m_Count = 0;
+};
+
+/// <summary>Read only memory mapping of a binary file of packed positions, positions are read in place</summary>
+/// <remark>Records are not validated when mapped, check IsValid before use</remark>
+class PackedPositionReader
+{
+public:
+	/// <returns>False if file can't be mapped, true for an empty file</returns>
+	bool Open(const std::string& path);
+	void Close();
+
+	size_t size() const { return m_Count; };
+	const PackedPosition* begin() const { return m_Positions; };
+	const PackedPosition* end() const { return m_Positions + m_Count; };
+	const PackedPosition& operator[](size_t idx) const { return m_Positions[idx]; };
+
+private:
+	MappedFile m_File;
+	const PackedPosition* m_Positions = nullptr;
+	size_t m_Count = 0;
+};
\ No newline at end of file
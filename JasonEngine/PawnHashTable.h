@@ -0,0 +1,30 @@
+#pragma once
+#include <memory>
+#include "BasicDefinitions.h"
+#include "Bitboard.h"
+
+/// <summary>Pawn hash table entry, evaluation of a pawn structure</summary>
+/// <remark>An empty entry (null hash) is a valid evaluation of a position without pawns</remark>
+struct PawnHashTableEntry
+{
+	uint64_t m_PawnHash = 0;
+	int m_Score = 0; //pawn structure score (>0 for white advantage, <0 for black), in centipawns
+	Bitboard m_WhitePassedPawns;
+	Bitboard m_BlackPassedPawns;
+	Bitboard m_WhitePawnFiles; //files with at least one white pawn
+	Bitboard m_BlackPawnFiles;
+};
+
+static_assert((PawnHashTableSize & (PawnHashTableSize - 1)) == 0);
+
+/// <summary>Pawn hash table, key is pawn hash % size</summary>
+class PawnHashTable
+{
+public:
+	PawnHashTable() { Clear(); };
+	PawnHashTableEntry& operator[](uint64_t pawnHash) { return (*m_Table)[pawnHash & (PawnHashTableSize - 1)]; };
+	void Clear() { m_Table.reset(new PHT); };
+private:
+	typedef std::array<PawnHashTableEntry, PawnHashTableSize> PHT;
+	std::unique_ptr<PHT> m_Table;
+};
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "PgnReader.h"
+#include "NotationParser.h"
+#include "PackedPosition.h"
+#include "MappedFile.h"
+#include <thread>
+#include <algorithm>
+
+std::string_view PgnGame::GetTag(std::string_view name) const
+{
+	for (const std::pair<std::string_view, std::string_view>& tag : m_Tags)
+	{
+		if (tag.first == name)
+			return tag.second;
+	}
+
+	return std::string_view();
+}
+
+static bool IsWhitespace(char c)
+{
+	return (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+}
+
+/// <returns>Index after closing character matching text[idx], nested openings included</returns>
+static size_t SkipBlock(std::string_view text, size_t idx, char opening, char closing)
+{
+	int depth = 0;
+	for (; idx < text.size(); idx++)
+	{
+		if (text[idx] == opening)
+			depth++;
+		else if (text[idx] == closing && --depth == 0)
+			return idx + 1;
+		else if (text[idx] == '{' && opening != '{') //comments in variations may contain parentheses
+			idx = SkipBlock(text, idx, '{', '}') - 1;
+	}
+
+	return text.size();
+}
+
+static size_t SkipLine(std::string_view text, size_t idx)
+{
+	const size_t end = text.find('\n', idx);
+	return (end == std::string_view::npos) ? text.size() : end + 1;
+}
+
+/// <summary>Read a tag line, e.g. [Event "Casual game"]</summary>
+/// <returns>Index of next line</returns>
+static size_t ReadTag(std::string_view text, size_t idx, PgnGame& game)
+{
+	const size_t nameBegin = idx + 1;
+	size_t nameEnd = nameBegin;
+	while (nameEnd < text.size() && !IsWhitespace(text[nameEnd]) && text[nameEnd] != '"' && text[nameEnd] != ']')
+		nameEnd++;
+
+	const size_t valueBegin = text.find('"', nameEnd);
+	const size_t lineEnd = SkipLine(text, idx);
+	if (valueBegin == std::string_view::npos || valueBegin >= lineEnd)
+		return lineEnd;
+
+	size_t valueEnd = valueBegin + 1;
+	while (valueEnd < lineEnd && (text[valueEnd] != '"' || text[valueEnd - 1] == '\\'))
+		valueEnd++;
+
+	game.m_Tags.emplace_back(text.substr(nameBegin, nameEnd - nameBegin), text.substr(valueBegin + 1, valueEnd - valueBegin - 1));
+	return lineEnd;
+}
+
+void PgnReader::Parse(std::string_view text, const GameCallback& gameCallback, const MoveCallback& moveCallback)
+{
+	static const Position StartPosition;
+
+	PgnGame game;
+	Position position;
+	size_t idx = 0;
+	while (idx < text.size())
+	{
+		game.m_Tags.clear();
+		game.m_Moves.clear();
+
+		//tag pairs
+		while (idx < text.size() && (IsWhitespace(text[idx]) || text[idx] == '['))
+			idx = (text[idx] == '[') ? ReadTag(text, idx, game) : idx + 1;
+		if (idx >= text.size() && game.m_Tags.empty())
+			break;
+
+		const std::string_view result = game.GetTag("Result");
+		game.m_HasResult = (result == "1-0" || result == "0-1" || result == "1/2-1/2");
+		game.m_Result = (result == "1-0") ? 2 : ((result == "0-1") ? 0 : 1);
+
+		const std::string_view fen = game.GetTag("FEN");
+		bool isValid = true;
+		if (fen.empty())
+			position = StartPosition;
+		else
+			isValid = NotationParser::ParseFEN(fen, position);
+
+		//movetext, until game termination marker or next tag pairs
+		bool isOver = false;
+		while (idx < text.size() && !isOver)
+		{
+			const char c = text[idx];
+			if (IsWhitespace(c))
+				idx++;
+			else if (c == '{')
+				idx = SkipBlock(text, idx, '{', '}');
+			else if (c == '(')
+				idx = SkipBlock(text, idx, '(', ')');
+			else if (c == ')')
+				idx++; //unbalanced variation end
+			else if (c == ';' || c == '%')
+				idx = SkipLine(text, idx);
+			else if (c == '[')
+				isOver = true;
+			else
+			{
+				const size_t tokenBegin = idx;
+				while (idx < text.size() && !IsWhitespace(text[idx]) && text[idx] != '{' && text[idx] != '(' && text[idx] != ')' && text[idx] != ';')
+					idx++;
+				std::string_view token = text.substr(tokenBegin, idx - tokenBegin);
+
+				if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*")
+				{
+					isOver = true;
+					continue;
+				}
+
+				//move number indication, e.g. 12. or 12... possibly followed by move
+				const size_t numberEnd = token.find_first_not_of("0123456789");
+				if (numberEnd == std::string_view::npos)
+					token = std::string_view();
+				else if (numberEnd > 0 && token[numberEnd] == '.')
+					token.remove_prefix(std::min(token.size(), token.find_first_not_of('.', numberEnd)));
+
+				if (token.empty() || token[0] == '$' || !isValid)
+					continue; //numeric annotation glyph, or move after an illegal move
+
+				const std::optional<Move> sanMove = NotationParser::TranslateFromSAN(position, token);
+				isValid = sanMove.has_value();
+				if (!isValid)
+					continue;
+
+				Move move = *sanMove;
+				if (moveCallback)
+					moveCallback(game, position, move);
+
+				//positions keep at most MaxPly moves, long games continue without history
+				if (position.GetMoves().size() + 1 >= MaxPly)
+				{
+					const std::optional<PackedPosition> packedPosition = PackedPosition::Pack(position);
+					isValid = packedPosition.has_value(); //more than 32 pieces from FEN tag
+					if (!isValid)
+						continue;
+
+					packedPosition->Unpack(position);
+				}
+
+				position.Update(move);
+				game.m_Moves.push_back(move);
+			}
+		}
+
+		if (isValid)
+		{
+			m_GameCount++;
+			gameCallback(game);
+		}
+		else
+			m_ErrorCount++;
+	}
+}
+
+size_t PgnReader::FindGameStart(std::string_view text, size_t offset)
+{
+	size_t idx = offset;
+	while ((idx = text.find("\n[", idx)) != std::string_view::npos)
+	{
+		const bool isAfterEmptyLine = (idx > 0 && text[idx - 1] == '\n') || (idx > 1 && text[idx - 1] == '\r' && text[idx - 2] == '\n');
+		if (isAfterEmptyLine)
+			return idx + 1;
+		idx++;
+	}
+
+	return text.size();
+}
+
+bool PgnReader::Read(const std::string& path, const GameCallback& gameCallback, const MoveCallback& moveCallback)
+{
+	MappedFile file;
+	if (!file.Open(path))
+		return false;
+
+	const std::string_view text(file.data(), file.size());
+	std::vector<size_t> chunkStarts = { 0 };
+	while (chunkStarts.back() + ChunkSize < text.size())
+		chunkStarts.push_back(FindGameStart(text, chunkStarts.back() + ChunkSize));
+	chunkStarts.push_back(text.size());
+
+	std::atomic<size_t> nextChunk = 0;
+	std::vector<std::thread> threads;
+	for (int threadIdx = 0; threadIdx < m_ThreadCount; threadIdx++)
+	{
+		threads.emplace_back([&]()
+		{
+			size_t chunkIdx = 0;
+			while ((chunkIdx = nextChunk++) + 1 < chunkStarts.size())
+				Parse(text.substr(chunkStarts[chunkIdx], chunkStarts[chunkIdx + 1] - chunkStarts[chunkIdx]), gameCallback, moveCallback);
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return true;
+}
\ No newline at end of file
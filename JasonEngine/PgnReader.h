@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <stdint.h>
+#include "Position.h"
+
+/// <summary>Game read from PGN, tags view the PGN text and are only valid during callbacks</summary>
+struct PgnGame
+{
+	std::vector<std::pair<std::string_view, std::string_view>> m_Tags; //names and values, in file order
+	std::vector<Move> m_Moves; //moves read so far, from start position
+	uint8_t m_Result = 1; //0 if black won, 1 if draw or unknown, 2 if white won
+	bool m_HasResult = false; //false if result tag is missing or unknown ("*")
+
+	/// <returns>Tag value, empty if game has no such tag</returns>
+	std::string_view GetTag(std::string_view name) const;
+};
+
+/// <summary>
+/// Streaming PGN reader: file is memory mapped and split in chunks at game boundaries, chunks are parsed in parallel
+/// </summary>
+/// <remark>Callbacks are called concurrently from worker threads, all callbacks of a game are called from the same thread</remark>
+class PgnReader
+{
+public:
+	/// <summary>Called for each move with position before move, game has its tags and previous moves</summary>
+	using MoveCallback = std::function<void(const PgnGame& game, const Position& position, const Move& move)>;
+	/// <summary>Called once all moves of a game are read, games with an illegal move are skipped</summary>
+	using GameCallback = std::function<void(const PgnGame& game)>;
+
+	PgnReader(int threadCount) : m_ThreadCount(threadCount) {};
+
+	/// <param name="moveCallback">optional</param>
+	/// <returns>False if file can't be read</returns>
+	bool Read(const std::string& path, const GameCallback& gameCallback, const MoveCallback& moveCallback = nullptr);
+
+	/// <summary>Read games of text on calling thread, text has to start at a game start</summary>
+	void Parse(std::string_view text, const GameCallback& gameCallback, const MoveCallback& moveCallback = nullptr);
+
+	/// <summary>Games read, and games skipped because of an illegal or unreadable move</summary>
+	uint64_t GetGameCount() const { return m_GameCount; };
+	uint64_t GetErrorCount() const { return m_ErrorCount; };
+
+private:
+	static constexpr size_t ChunkSize = 1 << 24; //approximate size of text parsed by a worker thread at once, in bytes
+
+	/// <returns>Index of first tag of first game starting after offset (tag line following an empty line), text size if none</returns>
+	static size_t FindGameStart(std::string_view text, size_t offset);
+
+	int m_ThreadCount = 1;
+	std::atomic<uint64_t> m_GameCount = 0;
+	std::atomic<uint64_t> m_ErrorCount = 0;
+};
\ No newline at end of file
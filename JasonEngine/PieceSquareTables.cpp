@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "PieceSquareTables.h"
+#include "PositionEvaluation.h"
+
+using SquareBonus = std::array<int, 64>;
+
+//Positional bonus tables, laid out as seen from white side: first row is rank 8, last row is rank 1
+
+static constexpr SquareBonus PawnMiddlegameBonus = {
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   5,   5,   0,   0,   0,
+	  0,   0,   5,  10,  10,   5,   0,   0,
+	  5,   0,   0,   5,   5,   0,   0,   5,
+	  5,   5,   5, -10, -10,   5,   5,   5,
+	  0,   0,   0,   0,   0,   0,   0,   0 };
+
+static constexpr SquareBonus PawnEndgameBonus = {
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	 30,  30,  30,  30,  30,  30,  30,  30,
+	 20,  20,  20,  20,  20,  20,  20,  20,
+	 10,  10,  10,  10,  10,  10,  10,  10,
+	  5,   5,   5,   5,   5,   5,   5,   5,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0 };
+
+static constexpr SquareBonus KnightBonus = {
+	-50, -40, -30, -30, -30, -30, -40, -50,
+	-40, -20,   0,   0,   0,   0, -20, -40,
+	-30,   0,  10,  15,  15,  10,   0, -30,
+	-30,   5,  15,  20,  20,  15,   5, -30,
+	-30,   0,  15,  20,  20,  15,   0, -30,
+	-30,   5,  10,  15,  15,  10,   5, -30,
+	-40, -20,   0,   5,   5,   0, -20, -40,
+	-50, -40, -30, -30, -30, -30, -40, -50 };
+
+static constexpr SquareBonus BishopBonus = {
+	-20, -10, -10, -10, -10, -10, -10, -20,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   5,  10,  10,   5,   0, -10,
+	-10,   5,   5,  10,  10,   5,   5, -10,
+	-10,   0,  10,  10,  10,  10,   0, -10,
+	-10,  10,  10,  10,  10,  10,  10, -10,
+	-10,   5,   0,   0,   0,   0,   5, -10,
+	-20, -10, -10, -10, -10, -10, -10, -20 };
+
+static constexpr SquareBonus RookMiddlegameBonus = {
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  5,  10,  10,  10,  10,  10,  10,   5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	  0,   0,   0,   5,   5,   0,   0,   0 };
+
+static constexpr SquareBonus RookEndgameBonus = {
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	 10,  10,  10,  10,  10,  10,  10,  10,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0 };
+
+static constexpr SquareBonus QueenBonus = {
+	-20, -10, -10,  -5,  -5, -10, -10, -20,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   5,   5,   5,   5,   0, -10,
+	 -5,   0,   5,   5,   5,   5,   0,  -5,
+	  0,   0,   5,   5,   5,   5,   0,  -5,
+	-10,   5,   5,   5,   5,   5,   0, -10,
+	-10,   0,   5,   0,   0,   0,   0, -10,
+	-20, -10, -10,  -5,  -5, -10, -10, -20 };
+
+static constexpr SquareBonus KingMiddlegameBonus = {
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-20, -30, -30, -40, -40, -30, -30, -20,
+	-10, -20, -20, -20, -20, -20, -20, -10,
+	 20,  20,   0,   0,   0,   0,  20,  20,
+	 20,  30,  10,   0,   0,  10,  30,  20 };
+
+static constexpr SquareBonus KingEndgameBonus = {
+	-50, -40, -30, -20, -20, -30, -40, -50,
+	-30, -20, -10,   0,   0, -10, -20, -30,
+	-30, -10,  20,  30,  30,  20, -10, -30,
+	-30, -10,  30,  40,  40,  30, -10, -30,
+	-30, -10,  30,  40,  40,  30, -10, -30,
+	-30, -10,  20,  30,  30,  20, -10, -30,
+	-30, -30,   0,   0,   0,   0, -30, -30,
+	-50, -30, -30, -30, -30, -30, -30, -50 };
+
+/// <summary>Add material value to positional bonus of each piece type, and flip bonus tables so that a1 = 0</summary>
+/// <remark>constexpr so tables are initialized before any static Position is constructed</remark>
+static constexpr PieceSquareTables::Table GenerateTable(const std::array<SquareBonus, 6>& bonus)
+{
+	PieceSquareTables::Table table = {};
+	for (int type = 0; type < 6; type++)
+		for (int square = 0; square < 64; square++)
+			table[type][square] = PositionEvaluation::GetPieceValue(static_cast<PieceType>(type)) + bonus[type][square ^ 56];
+
+	return table;
+}
+
+static constexpr PieceSquareTables::Table DefaultMiddlegameTable = GenerateTable({ PawnMiddlegameBonus, KnightBonus, BishopBonus, RookMiddlegameBonus, QueenBonus, KingMiddlegameBonus });
+static constexpr PieceSquareTables::Table DefaultEndgameTable = GenerateTable({ PawnEndgameBonus, KnightBonus, BishopBonus, RookEndgameBonus, QueenBonus, KingEndgameBonus });
+
+PieceSquareTables::Table PieceSquareTables::MiddlegameTable = DefaultMiddlegameTable;
+PieceSquareTables::Table PieceSquareTables::EndgameTable = DefaultEndgameTable;
+
+void PieceSquareTables::Reset()
+{
+	MiddlegameTable = DefaultMiddlegameTable;
+	EndgameTable = DefaultEndgameTable;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include "BasicDefinitions.h"
+
+/// <summary>
+/// Utility class holding middlegame and endgame value of each piece type on each square, material value included
+/// </summary>
+/// <remark>Tables are from white point of view (a1 = 0), squares are mirrored vertically for black</remark>
+class PieceSquareTables
+{
+public:
+	using Table = std::array<std::array<int, 64>, 6>; //[piece type][square]
+
+	/// <returns>Value of piece on square, > 0 for white and < 0 for black</returns>
+	static int GetMiddlegameValue(PieceType type, Square square, bool isWhite);
+	static int GetEndgameValue(PieceType type, Square square, bool isWhite);
+
+	/// <summary>Tables used for evaluation, may be modified (e.g. for tuning)</summary>
+	/// <remark>Positions keep sums of table values, Position::ComputePieceSquareScores must be called on existing positions after a change</remark>
+	static Table& GetMiddlegameTable() { return MiddlegameTable; };
+	static Table& GetEndgameTable() { return EndgameTable; };
+
+	/// <summary>Restore default tables</summary>
+	static void Reset();
+
+private:
+	static Table MiddlegameTable;
+	static Table EndgameTable;
+};
+
+inline int PieceSquareTables::GetMiddlegameValue(PieceType type, Square square, bool isWhite)
+{
+	return isWhite ? MiddlegameTable[static_cast<int>(type)][square] : -MiddlegameTable[static_cast<int>(type)][square ^ 56];
+}
+
+inline int PieceSquareTables::GetEndgameValue(PieceType type, Square square, bool isWhite)
+{
+	return isWhite ? EndgameTable[static_cast<int>(type)][square] : -EndgameTable[static_cast<int>(type)][square ^ 56];
+}
\ No newline at end of file
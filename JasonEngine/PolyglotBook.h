@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <optional>
+#include <random>
+#include <stdint.h>
+#include "BasicDefinitions.h"
+#include "MappedFile.h"
+
+class Position;
+
+/// <summary>
+/// Polyglot opening book (.bin): 16 bytes big endian entries (key, move, weight, learn) sorted by key, memory mapped and binary searched
+/// </summary>
+/// <remark>
+/// Keys are Polyglot hashes, not ZobristHash ones: they XOR the 781 standard Polyglot Random64 values.
+/// En passant key is only used when a pawn of side to move can capture en passant
+/// </remark>
+class PolyglotBook
+{
+public:
+	static constexpr int NumberOfKeys = 781;
+
+	/// <returns>Polyglot key of position</returns>
+	static uint64_t GetKey(const Position& position);
+
+	/// <returns>False if file can't be mapped or isn't a list of 16 bytes entries</returns>
+	bool Open(const std::string& path);
+	void Close();
+	bool IsOpen() const { return m_Entries != nullptr; };
+
+	/// <returns>Book move of position picked at random with entry weights, nullopt if position isn't in book or book can't be used</returns>
+	std::optional<Move> GetMove(Position& position, std::mt19937& generator) const;
+
+protected: //protected for testing
+	static constexpr size_t EntrySize = 16;
+
+	/// <returns>Move of book entry if it is legal in position, castling is encoded as king takes rook</returns>
+	static std::optional<Move> DecodeMove(Position& position, uint16_t bookMove);
+
+private:
+	static constexpr int CastleIdx = 768; //white king side, white queen side, black king side, black queen side
+	static constexpr int EnPassantIdx = 772; //A to H = 772 to 779
+	static constexpr int WhiteToMoveIdx = 780;
+
+	MappedFile m_File;
+	const uint8_t* m_Entries = nullptr;
+	size_t m_Count = 0;
+};
\ No newline at end of file
@@ -56,6 +56,10 @@ Position::Position()
 	m_BlackPiecesList.emplace_back(Piece(PieceType::Pawn, h7));
 
 	m_ZobristHash = ZobristHash::Init();
+	m_PawnHash = ComputePawnHash();
+	m_MaterialKey = ComputeMaterialKey();
+	ComputePieceSquareScores();
+	ComputeAccumulator();
 	CommitToHistory();
 }
 
@@ -74,6 +78,35 @@ void Position::InitEmptyBoard()
 	SetCanBlackCastleQueenSide(false);
 }
 
+void Position::Clear()
+{
+	for (bool isWhite : { true, false })
+	{
+		for (int type = 0; type < 6; type++)
+			GetPiecesOfType(static_cast<PieceType>(type), isWhite) = Bitboard();
+	}
+	m_WhitePieces = Bitboard();
+	m_BlackPieces = Bitboard();
+	m_WhitePiecesList.clear();
+	m_BlackPiecesList.clear();
+
+	m_IsWhiteToPlay = true;
+	m_GameStatus = GameStatus::Running;
+	m_CanWhiteCastleKingSide = false;
+	m_CanBlackCastleKingSide = false;
+	m_CanWhiteCastleQueenSide = false;
+	m_CanBlackCastleQueenSide = false;
+	m_HasWhiteCastled = false;
+	m_HasBlackCastled = false;
+	m_EnPassantSquare.reset();
+
+	m_Moves.clear();
+	m_PliesFromLastNullMove = 0;
+	m_PliesFromLastIrreversibleMove = 0;
+	m_FirstPly = 0;
+	m_RepetitionCount[0] = 0;
+}
+
 void Position::SetEnPassantSquare(Square square)
 {
 	ResetEnPassantSquare();
@@ -158,12 +191,15 @@ bool Position::IsInsufficientMaterial() const
 
 bool Position::IsInsufficientMaterialFromBitboards() const
 {
-	if ((m_WhitePawns > 0) || (m_BlackPawns > 0) ||
-		(m_WhiteRooks > 0) || (m_BlackRooks > 0) ||
-		(m_WhiteQueens > 0) || (m_BlackQueens > 0))
+	//read from material key: no pawn, rook or queen and at most one minor piece
+	constexpr uint64_t countMask = 15;
+	constexpr uint64_t minorPiecesMask = (countMask << GetMaterialKeyShift(PieceType::Knight, true)) | (countMask << GetMaterialKeyShift(PieceType::Bishop, true)) |
+		(countMask << GetMaterialKeyShift(PieceType::Knight, false)) | (countMask << GetMaterialKeyShift(PieceType::Bishop, false));
+	if ((m_MaterialKey & ~minorPiecesMask) != 0)
 		return false;
 
-	int minorPieceCount = (m_WhiteKnights | m_BlackKnights | m_WhiteBishops | m_BlackBishops).CountSetBits();
+	const int minorPieceCount = GetPieceCount(PieceType::Knight, true) + GetPieceCount(PieceType::Bishop, true) +
+		GetPieceCount(PieceType::Knight, false) + GetPieceCount(PieceType::Bishop, false);
 	return (minorPieceCount < 2);
 }
 
@@ -300,6 +336,90 @@ uint64_t Position::ComputeZobristHash() const
 	return hash;
 }
 
+uint64_t Position::ComputePawnHash() const
+{
+	uint64_t hash = 0;
+	for (bool isWhite : { true, false })
+	{
+		uint64_t bitset = GetPiecesOfType(PieceType::Pawn, isWhite);
+		while (bitset != 0)
+		{
+			const uint64_t t = bitset & (~bitset + 1);
+			hash ^= ZobristHash::GetKey(PieceType::Pawn, static_cast<Square>(_tzcnt_u64(bitset)), isWhite);
+			bitset ^= t;
+		}
+	}
+
+	return hash;
+}
+
+uint64_t Position::ComputeMaterialKey() const
+{
+	uint64_t key = 0;
+	for (int type = static_cast<int>(PieceType::Pawn); type < static_cast<int>(PieceType::King); type++)
+	{
+		for (bool isWhite : { true, false })
+			key += static_cast<uint64_t>(GetPiecesOfType(static_cast<PieceType>(type), isWhite).CountSetBits()) << GetMaterialKeyShift(static_cast<PieceType>(type), isWhite);
+	}
+
+	return key;
+}
+
+void Position::ComputePieceSquareScores()
+{
+	m_MiddlegameScore = 0;
+	m_EndgameScore = 0;
+	for (int type = static_cast<int>(PieceType::Pawn); type <= static_cast<int>(PieceType::King); type++)
+	{
+		for (bool isWhite : { true, false })
+		{
+			uint64_t bitset = GetPiecesOfType(static_cast<PieceType>(type), isWhite);
+			while (bitset != 0)
+			{
+				const uint64_t t = bitset & (~bitset + 1);
+				const Square square = static_cast<Square>(_tzcnt_u64(bitset));
+				m_MiddlegameScore += PieceSquareTables::GetMiddlegameValue(static_cast<PieceType>(type), square, isWhite);
+				m_EndgameScore += PieceSquareTables::GetEndgameValue(static_cast<PieceType>(type), square, isWhite);
+				bitset ^= t;
+			}
+		}
+	}
+}
+
+void Position::ComputeAccumulator()
+{
+	if (!NeuralNetwork::IsLoaded())
+		return;
+
+	NeuralNetwork::ResetAccumulator(m_Accumulator);
+	for (int type = static_cast<int>(PieceType::Pawn); type <= static_cast<int>(PieceType::King); type++)
+	{
+		for (bool isWhite : { true, false })
+		{
+			uint64_t bitset = GetPiecesOfType(static_cast<PieceType>(type), isWhite);
+			while (bitset != 0)
+			{
+				const uint64_t t = bitset & (~bitset + 1);
+				NeuralNetwork::AddPiece(m_Accumulator, static_cast<PieceType>(type), static_cast<Square>(_tzcnt_u64(bitset)), isWhite);
+				bitset ^= t;
+			}
+		}
+	}
+}
+
+void Position::InitFromBitboards()
+{
+	m_WhitePieces = m_WhitePawns | m_WhiteKnights | m_WhiteBishops | m_WhiteRooks | m_WhiteQueens | m_WhiteKing;
+	m_BlackPieces = m_BlackPawns | m_BlackKnights | m_BlackBishops | m_BlackRooks | m_BlackQueens | m_BlackKing;
+
+	m_ZobristHash = ComputeZobristHash();
+	m_PawnHash = ComputePawnHash();
+	m_MaterialKey = ComputeMaterialKey();
+	ComputePieceSquareScores();
+	ComputeAccumulator();
+	CommitToHistory();
+}
+
 void Position::Update(Move& move)
 {
 	//misc backups
@@ -726,6 +846,29 @@ void Position::UpdateSquare(PieceType type, Square square, bool isWhite)
 
 	//update zobrist hash the same way
 	m_ZobristHash ^= ZobristHash::GetKey(type, square, isWhite);
+	if (type == PieceType::Pawn)
+		m_PawnHash ^= ZobristHash::GetKey(type, square, isWhite);
+
+	//add or remove piece-square values depending on whether the piece was put on or removed from square
+	const bool isAdded = (GetPiecesOfType(type, isWhite) & movedPiece);
+	const int sign = isAdded ? 1 : -1;
+	m_MiddlegameScore += sign * PieceSquareTables::GetMiddlegameValue(type, square, isWhite);
+	m_EndgameScore += sign * PieceSquareTables::GetEndgameValue(type, square, isWhite);
+	if (type != PieceType::King)
+	{
+		if (isAdded)
+			m_MaterialKey += 1ULL << GetMaterialKeyShift(type, isWhite);
+		else
+			m_MaterialKey -= 1ULL << GetMaterialKeyShift(type, isWhite);
+	}
+
+	if (NeuralNetwork::IsLoaded())
+	{
+		if (isAdded)
+			NeuralNetwork::AddPiece(m_Accumulator, type, square, isWhite);
+		else
+			NeuralNetwork::RemovePiece(m_Accumulator, type, square, isWhite);
+	}
 }
 
 void Position::UpdateCapturedPiece(Square squareIdx, Move& move)
@@ -746,6 +889,8 @@ void Position::UpdateCapturedPiece(Square squareIdx, Move& move)
 		*bitboard ^= (*bitboard & captureSquare);
 		move.SetCapture(PieceType::Pawn, squareIdx);
 		m_ZobristHash ^= ZobristHash::GetKey(PieceType::Pawn, squareIdx, !m_IsWhiteToPlay);
+		m_PawnHash ^= ZobristHash::GetKey(PieceType::Pawn, squareIdx, !m_IsWhiteToPlay);
+		RemoveFromScores(PieceType::Pawn, squareIdx, !m_IsWhiteToPlay);
 		return;
 	}
 
@@ -755,6 +900,7 @@ void Position::UpdateCapturedPiece(Square squareIdx, Move& move)
 		*bitboard ^= (*bitboard & captureSquare);
 		move.SetCapture(PieceType::Knight, squareIdx);
 		m_ZobristHash ^= ZobristHash::GetKey(PieceType::Knight, squareIdx, !m_IsWhiteToPlay);
+		RemoveFromScores(PieceType::Knight, squareIdx, !m_IsWhiteToPlay);
 		return;
 	}
 
@@ -764,6 +910,7 @@ void Position::UpdateCapturedPiece(Square squareIdx, Move& move)
 		*bitboard ^= (*bitboard & captureSquare);
 		move.SetCapture(PieceType::Bishop, squareIdx);
 		m_ZobristHash ^= ZobristHash::GetKey(PieceType::Bishop, squareIdx, !m_IsWhiteToPlay);
+		RemoveFromScores(PieceType::Bishop, squareIdx, !m_IsWhiteToPlay);
 		return;
 	}
 
@@ -773,6 +920,7 @@ void Position::UpdateCapturedPiece(Square squareIdx, Move& move)
 		*bitboard ^= (*bitboard & captureSquare);
 		move.SetCapture(PieceType::Rook, squareIdx);
 		m_ZobristHash ^= ZobristHash::GetKey(PieceType::Rook, squareIdx, !m_IsWhiteToPlay);
+		RemoveFromScores(PieceType::Rook, squareIdx, !m_IsWhiteToPlay);
 		return;
 	}
 
@@ -782,6 +930,7 @@ void Position::UpdateCapturedPiece(Square squareIdx, Move& move)
 		*bitboard ^= (*bitboard & captureSquare);
 		move.SetCapture(PieceType::Queen, squareIdx);
 		m_ZobristHash ^= ZobristHash::GetKey(PieceType::Queen, squareIdx, !m_IsWhiteToPlay);
+		RemoveFromScores(PieceType::Queen, squareIdx, !m_IsWhiteToPlay);
 		return;
 	}
 
@@ -791,10 +940,22 @@ void Position::UpdateCapturedPiece(Square squareIdx, Move& move)
 		*bitboard ^= (*bitboard & captureSquare);
 		move.SetCapture(PieceType::King, squareIdx);
 		m_ZobristHash ^= ZobristHash::GetKey(PieceType::King, squareIdx, !m_IsWhiteToPlay);
+		RemoveFromScores(PieceType::King, squareIdx, !m_IsWhiteToPlay);
 		return;
 	}	
 }
 
+void Position::RemoveFromScores(PieceType type, Square square, bool isWhite)
+{
+	m_MiddlegameScore -= PieceSquareTables::GetMiddlegameValue(type, square, isWhite);
+	m_EndgameScore -= PieceSquareTables::GetEndgameValue(type, square, isWhite);
+	if (type != PieceType::King)
+		m_MaterialKey -= 1ULL << GetMaterialKeyShift(type, isWhite);
+
+	if (NeuralNetwork::IsLoaded())
+		NeuralNetwork::RemovePiece(m_Accumulator, type, square, isWhite);
+}
+
 void Position::UpdateEnPassantSquare(Move& move)
 {
 	if (m_EnPassantSquare.has_value())
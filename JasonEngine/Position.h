@@ -2,6 +2,8 @@
 #include "BasicDefinitions.h"
 #include "Bitboard.h"
 #include "ZobristHash.h"
+#include "PieceSquareTables.h"
+#include "NeuralNetwork.h"
 #include <array>
 #include <vector>
 #include <optional>
@@ -31,6 +33,11 @@ public:
 	/// </summary>
 	void InitEmptyBoard();
 
+	/// <summary>
+	/// Remove pieces, moves, castling rights and en passant square, white to play ; hashes are computed by InitFromBitboards once pieces are set
+	/// </summary>
+	void Clear();
+
 	/// <remark>move is updated too to take into account captures</remark>
 	void Update(Move& move);
 	void Undo(const Move& move);
@@ -139,6 +146,14 @@ public:
 	/// </summary>
 	std::vector<Piece> GetPiecesToPlay() const;
 
+	/// <summary>Plies since last capture or pawn move, for fifty move rule</summary>
+	int GetPliesFromLastIrreversibleMove() const { return m_PliesFromLastIrreversibleMove; };
+	void SetPliesFromLastIrreversibleMove(int plies) { m_PliesFromLastIrreversibleMove = plies; };
+
+	/// <summary>Full move number as in FEN, starts at 1 and is incremented after black moves</summary>
+	int GetFullMoveNumber() const { return (m_FirstPly + static_cast<int>(m_Moves.size())) / 2 + 1; };
+	void SetFullMoveNumber(int fullMoveNumber) { m_FirstPly = 2 * (fullMoveNumber - 1) + (m_IsWhiteToPlay ? 0 : 1) - static_cast<int>(m_Moves.size()); };
+
 	const MoveList<MaxPly>& GetMoves() const { return m_Moves; };
 	MoveList<MaxPly>& GetMoves() { return m_Moves; };
 
@@ -153,6 +168,49 @@ public:
 	/// </summary>
 	uint64_t ComputeZobristHash() const;
 
+	/// <summary>Zobrist hash of pawns only, for pawn structure evaluation cache</summary>
+	uint64_t GetPawnHash() const { return m_PawnHash; };
+	void SetPawnHash(uint64_t hash) { m_PawnHash = hash; };
+
+	/// <summary>
+	/// Recompute pawn hash from scratch
+	/// </summary>
+	uint64_t ComputePawnHash() const;
+
+	/// <summary>Piece counts of each color and type (kings excepted) packed on 4 bits each, for material table</summary>
+	uint64_t GetMaterialKey() const { return m_MaterialKey; };
+	void SetMaterialKey(uint64_t key) { m_MaterialKey = key; };
+
+	/// <summary>
+	/// Recompute material key from scratch
+	/// </summary>
+	uint64_t ComputeMaterialKey() const;
+
+	/// <returns>Number of pieces of given type (not king) and color, read from material key</returns>
+	int GetPieceCount(PieceType type, bool isWhite) const { return static_cast<int>((m_MaterialKey >> GetMaterialKeyShift(type, isWhite)) & 15); };
+
+	/// <summary>Material and piece-square scores, updated incrementally (>0 for white advantage, <0 for black)</summary>
+	int GetMiddlegameScore() const { return m_MiddlegameScore; };
+	int GetEndgameScore() const { return m_EndgameScore; };
+
+	/// <summary>
+	/// Recompute middlegame and endgame scores from scratch
+	/// </summary>
+	void ComputePieceSquareScores();
+
+	/// <summary>Neural network hidden layer, updated incrementally only if a network is loaded</summary>
+	const NeuralNetwork::Accumulator& GetAccumulator() const { return m_Accumulator; };
+
+	/// <summary>
+	/// Recompute neural network accumulator from scratch, if a network is loaded
+	/// </summary>
+	void ComputeAccumulator();
+
+	/// <summary>
+	/// Compute pieces sets, hashes, incremental scores and history from piece type bitboards, once they are set
+	/// </summary>
+	void InitFromBitboards();
+
 	bool operator==(const Position& position) const
 	{
 		return (m_ZobristHash == position.GetZobristHash());
@@ -182,6 +240,10 @@ private:
 
 	/// <param name="capturedPiece">Captured piece if any [OUT]</param>
 	void UpdateCapturedPiece(Square square, Move& move);
+	/// <summary>Remove captured piece from incremental scores and material key</summary>
+	void RemoveFromScores(PieceType type, Square square, bool isWhite);
+
+	static constexpr int GetMaterialKeyShift(PieceType type, bool isWhite) { return 4 * ((isWhite ? 0 : 5) + static_cast<int>(type)); };
 
 	/// <summary>Update en passant and backup current square</summary>
 	void UpdateEnPassantSquare(Move& move);
@@ -222,11 +284,18 @@ private:
 	MoveList<MaxPly> m_Moves; //list of moves made to reach the position
 	int m_PliesFromLastNullMove = 0; //nb of plies since last null move
 	int m_PliesFromLastIrreversibleMove = 0; //nb of plies since last irreversible move
+	int m_FirstPly = 0; //ply number of position before m_Moves were played, 0 for start position
 
 	std::array<uint64_t, MaxPly + 1> m_History = {}; //history of previously visited positions ; current index is m_Moves.size()
 	std::array<int, MaxPly + 1> m_RepetitionCount = {}; //repetition count : 0, 1 or 2 (2 == repetition draw)
 
 	uint64_t m_ZobristHash = 0;
+	uint64_t m_PawnHash = 0;
+	uint64_t m_MaterialKey = 0;
+
+	int m_MiddlegameScore = 0; //sum of piece-square values, white minus black
+	int m_EndgameScore = 0;
+	NeuralNetwork::Accumulator m_Accumulator;
 
 	friend class MoveMakerTests;
 };
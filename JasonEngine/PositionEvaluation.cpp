@@ -4,39 +4,22 @@
 #include "MoveSearcher.h"
 #include "BitboardUtility.h"
 #include <assert.h>
+#include <fstream>
 
-/// <summary>Absolute score for a mate</summary>
-static int BishopPairBonus = 15;
-static int CastlingBonus = 50;
+static bool UseTunableParameters = false; //evaluate with TunableParameters once parameters are loaded, DefaultParameters otherwise
+static int ParametersVersion = 0; //incremented when parameters change, invalidates cached scores
 
-static int CenterPawnBonus = 40;
-static int DoubledPawnPunishment = -20; //40 for a pair
-static int IsolatedPawnPunishment = -40;
-static int BackwardsPawnPunishment = -20;
-static int PassedPawnBonus = 40;
-static std::array<int, 3> AdvancedPawnBonus = {30, 40, 50}; //on rows 5, 6, 7 or 4, 3, 2
-static int SquareBehindPawnBonus = 1;
+/// <summary>Pawn structure and evaluation caches, one per thread</summary>
+static thread_local PawnHashTable PawnTable;
+static thread_local EvaluationCache EvalCache;
+static thread_local MaterialTable MaterialCache;
+static thread_local int CachesVersion = 0;
 
-static int KnightEndgamePunishment = -10;
-static int BishopEndgamePunishment = 10;
+static constexpr int OppositeBishopsScaleFactor = 32; //bishops of opposite colors endings are drawish
 
-static int RookOnSemiOpenFileBonus = 20;
-static int RookOnOpenFileBonus = 30;
+static constexpr int LazyEvaluationMargin = 500; //max expected contribution of positional terms, for lazy evaluation
 
-static int Blocking_d_or_ePawnPunishment = -40; //Punishment for blocking unmoved pawns on d and e files
-
-static int KnightPawnBonus = 2; //Knights better with lots of pawns
-static int BishopPawnPunishment = -2; //Bishops worse with lots of pawns
-static int RookPawnPunishment = -2; //Rooks worse with lots of pawns
-
-static int AttackedSquareBonusFactor = 0;
-static int CenterAttackedBonusFactor = 1; //Factor to multiply with how many center squares are attacked by own pieces
-static int KingSquaresAttackBonusFactor = 5; //Factor to multiply with how many squares around enemy king that are attacked by own pieces
-
-static int SamePieceTwicePunishment = -50; //Penaly for moving same piece twice in opening
-static int TempoBonus = 30;
-
-int PositionEvaluation::EvaluatePosition(Position& position, int ply)
+int PositionEvaluation::EvaluatePosition(Position& position, int ply, int alpha, int beta)
 {
 	//Check checkmate/stalemate
 	switch (position.GetGameStatus())
@@ -54,99 +37,102 @@ int PositionEvaluation::EvaluatePosition(Position& position, int ply)
 			break;
 	}
 
-	//Tempo bonus
-	int score = (position.IsWhiteToPlay() ? 1 : -1) * TempoBonus;
+	if (NeuralNetwork::IsUsed())
+		return NeuralNetwork::Evaluate(position);
 
-	//Check material
-	score += CountMaterial(position, true) - CountMaterial(position, false);
+	return UseTunableParameters ? EvaluateBoard<TunableParameters>(position, alpha, beta) : EvaluateBoard<DefaultParameters>(position, alpha, beta);
+}
 
-	//Check development
-	if (position.GetMoves().size() < 25)
-	{
-		score += GetUndevelopedPiecesPunishment(position, true);
-		score -= GetUndevelopedPiecesPunishment(position, false);
-	}
+template<class Parameters>
+int PositionEvaluation::EvaluateBoard(Position& position, int alpha, int beta)
+{
+	ClearOutdatedCaches();
+
+	const int movesHistoryScore = EvaluateMovesHistory<Parameters>(position);
+	EvaluationCacheEntry& entry = EvalCache[position.GetZobristHash()];
+	if (entry.m_ZobristHash == position.GetZobristHash())
+		return entry.m_Score + movesHistoryScore;
+
+	//Lazy evaluation: positional terms can't bring score back inside alpha-beta window
+	const int materialScore = EvaluateMaterial<Parameters>(position);
+	const int lazyScore = materialScore + movesHistoryScore;
+	if ((lazyScore + LazyEvaluationMargin <= alpha) || (lazyScore - LazyEvaluationMargin >= beta))
+		return lazyScore;
+
+	entry.m_ZobristHash = position.GetZobristHash();
+	entry.m_Score = materialScore + EvaluatePositionalTerms<Parameters>(position);
+	return entry.m_Score + movesHistoryScore;
+}
 
-	//Bishop pair bonus
-	if (position.GetWhiteBishops().CountSetBits() >= 2)
-		score += BishopPairBonus;
-	if (position.GetBlackBishops().CountSetBits() >= 2)
-		score -= BishopPairBonus;
-
-	//Piece type bonus according to number of pawns left
-	int allPawnsCount = (position.GetWhitePawns() | position.GetBlackPawns()).CountSetBits();
-	score += allPawnsCount * position.GetWhiteKnights().CountSetBits() * KnightPawnBonus;
-	score -= allPawnsCount * position.GetBlackKnights().CountSetBits() * KnightPawnBonus;
-	score += allPawnsCount * position.GetWhiteBishops().CountSetBits() * BishopPawnPunishment;
-	score -= allPawnsCount * position.GetBlackBishops().CountSetBits() * BishopPawnPunishment;
-	score += allPawnsCount * position.GetWhiteRooks().CountSetBits() * RookPawnPunishment;
-	score -= allPawnsCount * position.GetBlackRooks().CountSetBits() * RookPawnPunishment;
+template<class Parameters>
+int PositionEvaluation::EvaluateMaterial(const Position& position)
+{
+	const EvaluationParameters& weights = Parameters::Values;
 
-	//Rook on open files
-	std::pair<int, int> whiteRooksOnOpenFiles = PositionEvaluation::CountRooksOnOpenFiles(position, true);
-	std::pair<int, int> blackRooksOnOpenFiles = PositionEvaluation::CountRooksOnOpenFiles(position, false);
-	score += whiteRooksOnOpenFiles.first * RookOnOpenFileBonus;
-	score += whiteRooksOnOpenFiles.second * RookOnSemiOpenFileBonus;
-	score -= blackRooksOnOpenFiles.first * RookOnOpenFileBonus;
-	score -= blackRooksOnOpenFiles.second * RookOnSemiOpenFileBonus;
+	//Tempo bonus
+	int score = (position.IsWhiteToPlay() ? 1 : -1) * weights.m_TempoBonus;
 
-	//Penalty for moving same pieces twice
-	//Removal of this makes tacticsTest fails (tactic2200)... should investigate!
-	if (position.GetMoves().size() > 3)
-	{
-		const int lastIdx = static_cast<int>(position.GetMoves().size()) - 1;
-		if (position.GetMoves()[lastIdx].GetFromSquare() == position.GetMoves()[lastIdx - 2].GetToSquare())
-			score += (position.IsWhiteToPlay() ? SamePieceTwicePunishment : -SamePieceTwicePunishment);
-	}
+	//Material imbalance: bishop pair, piece types according to number of pawns
+	const MaterialTableEntry& material = GetMaterialEntry<Parameters>(position);
+	score += material.m_Score;
 
-	//Center pawns bonus
-	score += CountCenterPawns(position, true) * CenterPawnBonus;
-	score -= CountCenterPawns(position, false) * CenterPawnBonus;
+	//Material and piece-square values, kept up to date by Position, tapered between middlegame and endgame
+	//endgame score is scaled down when the side ahead can hardly win
+	const int phase = material.m_GamePhase;
+	const int endgameScore = position.GetEndgameScore() * GetScaleFactor(position, material, position.GetEndgameScore() > 0) / NormalScaleFactor;
+	score += (position.GetMiddlegameScore() * phase + endgameScore * (MaxGamePhase - phase)) / MaxGamePhase;
 
-	//Double pawn punishment
-	score += CountDoubledPawns(position, true) * DoubledPawnPunishment;
-	score -= CountDoubledPawns(position, false) * DoubledPawnPunishment;
+	return score;
+}
 
-	//Isolated pawn punishment
-	score += CountIsolatedPawns(position, true) * IsolatedPawnPunishment;
-	score -= CountIsolatedPawns(position, false) * IsolatedPawnPunishment;
+template<class Parameters>
+int PositionEvaluation::EvaluatePositionalTerms(Position& position)
+{
+	const EvaluationParameters& weights = Parameters::Values;
 
-	//Backwards pawn punishment
-	score += CountBackwardsPawns(position, true) * BackwardsPawnPunishment;
-	score -= CountBackwardsPawns(position, false) * BackwardsPawnPunishment;
+	int score = 0;
 
-	//Passed pawn bonus
-	score += CountPassedPawns(position, true) * PassedPawnBonus;
-	score -= CountPassedPawns(position, false) * PassedPawnBonus;
+	//Check development, only matters in middlegame
+	score += (GetUndevelopedPiecesPunishment(position, true) - GetUndevelopedPiecesPunishment(position, false)) * GetMaterialEntry<Parameters>(position).m_GamePhase / MaxGamePhase;
 
-	//Advanced pawns bonus
-	score += GetAdvancedPawnsBonus(position, true);
-	score -= GetAdvancedPawnsBonus(position, false);
+	//Pawn structure: center, doubled, isolated, backwards, passed and advanced pawns, space behind pawns
+	const PawnHashTableEntry& pawnStructure = GetPawnStructure<Parameters>(position);
+	score += pawnStructure.m_Score;
+
+	//Rook on open files
+	std::pair<int, int> whiteRooksOnOpenFiles = PositionEvaluation::CountRooksOnOpenFiles(position, pawnStructure.m_WhitePawnFiles, pawnStructure.m_BlackPawnFiles, true);
+	std::pair<int, int> blackRooksOnOpenFiles = PositionEvaluation::CountRooksOnOpenFiles(position, pawnStructure.m_WhitePawnFiles, pawnStructure.m_BlackPawnFiles, false);
+	score += whiteRooksOnOpenFiles.first * weights.m_RookOnOpenFileBonus;
+	score += whiteRooksOnOpenFiles.second * weights.m_RookOnSemiOpenFileBonus;
+	score -= blackRooksOnOpenFiles.first * weights.m_RookOnOpenFileBonus;
+	score -= blackRooksOnOpenFiles.second * weights.m_RookOnSemiOpenFileBonus;
 
 	//Piece blocking d or e pawn punishment
-	score += CountBlockedEorDPawns(position, true) * Blocking_d_or_ePawnPunishment;
-	score -= CountBlockedEorDPawns(position, false) * Blocking_d_or_ePawnPunishment;
+	score += CountBlockedEorDPawns(position, true) * weights.m_Blocking_d_or_ePawnPunishment;
+	score -= CountBlockedEorDPawns(position, false) * weights.m_Blocking_d_or_ePawnPunishment;
 
-	//Space
-	score += GetSpaceBehindPawns(position, true) * SquareBehindPawnBonus;
-	score -= GetSpaceBehindPawns(position, false) * SquareBehindPawnBonus;
-
-	//Castling bonus: castling improves score during opening, importance of castling decays during the game
-	const int castleBonus = CastlingBonus * std::max(0, 40 - static_cast<int>(position.GetMoves().size())) / 40;
-	if (position.HasWhiteCastled())
-		score += castleBonus;
-	if (position.HasBlackCastled())
-		score -= castleBonus;
-
-	Bitboard whiteAttackedSquares = GetAttackedSquares(position, true);
-	Bitboard blackAttackedSquares = GetAttackedSquares(position, false);
-	score += whiteAttackedSquares.CountSetBits() * AttackedSquareBonusFactor;
-	score -= blackAttackedSquares.CountSetBits() * AttackedSquareBonusFactor;
-
-	Bitboard attackedSquaresAroundWhiteKing = GetAttackedSquaresAroundKing(position, blackAttackedSquares, true);
-	Bitboard attackedSquaresAroundBlackKing = GetAttackedSquaresAroundKing(position, whiteAttackedSquares, false);
-	score += attackedSquaresAroundBlackKing.CountSetBits() * KingSquaresAttackBonusFactor;
-	score -= attackedSquaresAroundWhiteKing.CountSetBits() * KingSquaresAttackBonusFactor;
+	//Attacks: mobility, center control and king safety
+	const AttackInfo whiteAttacks = GetAttackInfo<Parameters>(position, true);
+	const AttackInfo blackAttacks = GetAttackInfo<Parameters>(position, false);
+	score += whiteAttacks.m_AttackedSquares.CountSetBits() * weights.m_AttackedSquareBonusFactor;
+	score -= blackAttacks.m_AttackedSquares.CountSetBits() * weights.m_AttackedSquareBonusFactor;
+
+	score += whiteAttacks.m_Mobility - blackAttacks.m_Mobility;
+
+	const Bitboard center = _d4 | _e4 | _d5 | _e5;
+	score += (whiteAttacks.m_AttackedSquares & center).CountSetBits() * weights.m_CenterAttackedBonusFactor;
+	score -= (blackAttacks.m_AttackedSquares & center).CountSetBits() * weights.m_CenterAttackedBonusFactor;
+
+	Bitboard attackedSquaresAroundWhiteKing = GetAttackedSquaresAroundKing(position, blackAttacks.m_AttackedSquares, true);
+	Bitboard attackedSquaresAroundBlackKing = GetAttackedSquaresAroundKing(position, whiteAttacks.m_AttackedSquares, false);
+	score += attackedSquaresAroundBlackKing.CountSetBits() * weights.m_KingSquaresAttackBonusFactor;
+	score -= attackedSquaresAroundWhiteKing.CountSetBits() * weights.m_KingSquaresAttackBonusFactor;
+
+	//a single piece near the king is seldom a threat, weights only count from two attackers
+	if (whiteAttacks.m_KingAttackersCount >= 2)
+		score += whiteAttacks.m_KingAttackersWeight;
+	if (blackAttacks.m_KingAttackersCount >= 2)
+		score -= blackAttacks.m_KingAttackersWeight;
 
 	//////////////////////////
 	//Check space behind pawns
@@ -154,6 +140,43 @@ int PositionEvaluation::EvaluatePosition(Position& position, int ply)
 	return score;
 }
 
+template<class Parameters>
+int PositionEvaluation::EvaluateMovesHistory(const Position& position)
+{
+	const EvaluationParameters& weights = Parameters::Values;
+
+	int score = 0;
+
+	//Penalty for moving same pieces twice
+	//Removal of this makes tacticsTest fails (tactic2200)... should investigate!
+	if (position.GetMoves().size() > 3)
+	{
+		const int lastIdx = static_cast<int>(position.GetMoves().size()) - 1;
+		if (position.GetMoves()[lastIdx].GetFromSquare() == position.GetMoves()[lastIdx - 2].GetToSquare())
+			score += (position.IsWhiteToPlay() ? weights.m_SamePieceTwicePunishment : -weights.m_SamePieceTwicePunishment);
+	}
+
+	//Castling bonus: castling improves score during opening, importance of castling decays as pieces are traded
+	if (position.HasWhiteCastled() != position.HasBlackCastled())
+	{
+		const int castleBonus = weights.m_CastlingBonus * GetMaterialEntry<Parameters>(position).m_GamePhase / MaxGamePhase;
+		score += (position.HasWhiteCastled() ? castleBonus : -castleBonus);
+	}
+
+	return score;
+}
+
+void PositionEvaluation::ClearOutdatedCaches()
+{
+	if (CachesVersion != ParametersVersion)
+	{
+		PawnTable.Clear();
+		EvalCache.Clear();
+		MaterialCache.Clear();
+		CachesVersion = ParametersVersion;
+	}
+}
+
 bool PositionEvaluation::IsPositionQuiet(const Position& position)
 {
 	//THIS IS COMPLETELY WRONG! SHOULD CHECK UNDEFENDED PIECES ETC...
@@ -173,108 +196,185 @@ std::optional<int> PositionEvaluation::GetMovesToMate(int score)
 	return count;
 }
 
-void PositionEvaluation::LoadParameters(std::vector<int> parameters)
+/// <returns>Scalar parameters, indexed by PositionEvaluation::ParameterIndex</returns>
+static std::array<int*, PositionEvaluation::NumberOfScalarParameters> GetScalarParameters(EvaluationParameters& weights)
 {
-	BishopPairBonus = parameters[0];
-	CastlingBonus = parameters[1];
+	std::array<int*, PositionEvaluation::NumberOfScalarParameters> parameters = {};
+	parameters[PositionEvaluation::BishopPairBonusIndex] = &weights.m_BishopPairBonus;
+	parameters[PositionEvaluation::CastlingBonusIndex] = &weights.m_CastlingBonus;
+
+	parameters[PositionEvaluation::CenterPawnBonusIndex] = &weights.m_CenterPawnBonus;
+	parameters[PositionEvaluation::DoubledPawnPunishmentIndex] = &weights.m_DoubledPawnPunishment;
+	parameters[PositionEvaluation::IsolatedPawnPunishmentIndex] = &weights.m_IsolatedPawnPunishment;
+	parameters[PositionEvaluation::BackwardsPawnPunishmentIndex] = &weights.m_BackwardsPawnPunishment;
+	parameters[PositionEvaluation::PassedPawnBonusIndex] = &weights.m_PassedPawnBonus;
+	for (size_t i = 0; i < weights.m_AdvancedPawnBonus.size(); i++)
+		parameters[PositionEvaluation::AdvancedPawnBonusIndex + i] = &weights.m_AdvancedPawnBonus[i];
+	parameters[PositionEvaluation::SquareBehindPawnBonusIndex] = &weights.m_SquareBehindPawnBonus;
+
+	parameters[PositionEvaluation::KnightEndgamePunishmentIndex] = &weights.m_KnightEndgamePunishment;
+	parameters[PositionEvaluation::BishopEndgamePunishmentIndex] = &weights.m_BishopEndgamePunishment;
 
-	CenterPawnBonus = parameters[2];
-	DoubledPawnPunishment = parameters[3];
-	IsolatedPawnPunishment = parameters[4];
-	BackwardsPawnPunishment = parameters[5];
-	PassedPawnBonus = parameters[6];
-	AdvancedPawnBonus = { parameters[7], parameters[8], parameters[9] };
-	SquareBehindPawnBonus = parameters[10];
+	parameters[PositionEvaluation::RookOnSemiOpenFileBonusIndex] = &weights.m_RookOnSemiOpenFileBonus;
+	parameters[PositionEvaluation::RookOnOpenFileBonusIndex] = &weights.m_RookOnOpenFileBonus;
 
-	KnightEndgamePunishment = parameters[11];
-	BishopEndgamePunishment = parameters[12];
+	parameters[PositionEvaluation::Blocking_d_or_ePawnPunishmentIndex] = &weights.m_Blocking_d_or_ePawnPunishment;
 
-	RookOnSemiOpenFileBonus = parameters[13];
-	RookOnOpenFileBonus = parameters[14];
+	parameters[PositionEvaluation::KnightPawnBonusIndex] = &weights.m_KnightPawnBonus;
+	parameters[PositionEvaluation::BishopPawnPunishmentIndex] = &weights.m_BishopPawnPunishment;
+	parameters[PositionEvaluation::RookPawnPunishmentIndex] = &weights.m_RookPawnPunishment;
 
-	Blocking_d_or_ePawnPunishment = parameters[15];
+	parameters[PositionEvaluation::AttackedSquareBonusFactorIndex] = &weights.m_AttackedSquareBonusFactor;
+	parameters[PositionEvaluation::CenterAttackedBonusFactorIndex] = &weights.m_CenterAttackedBonusFactor;
+	parameters[PositionEvaluation::KingSquaresAttackBonusFactorIndex] = &weights.m_KingSquaresAttackBonusFactor;
 
-	KnightPawnBonus = parameters[16];
-	BishopPawnPunishment = parameters[17];
-	RookPawnPunishment = parameters[18];
+	parameters[PositionEvaluation::SamePieceTwicePunishmentIndex] = &weights.m_SamePieceTwicePunishment;
+	parameters[PositionEvaluation::TempoBonusIndex] = &weights.m_TempoBonus;
 
-	AttackedSquareBonusFactor = parameters[19];
-	CenterAttackedBonusFactor = parameters[20];
-	KingSquaresAttackBonusFactor = parameters[21];
+	for (size_t i = 0; i < weights.m_MobilityBonus.size(); i++)
+		parameters[PositionEvaluation::MobilityBonusIndex + i] = &weights.m_MobilityBonus[i];
+	for (size_t i = 0; i < weights.m_KingAttackerWeight.size(); i++)
+		parameters[PositionEvaluation::KingAttackerWeightIndex + i] = &weights.m_KingAttackerWeight[i];
 
-	SamePieceTwicePunishment = parameters[22];
-	TempoBonus = parameters[23];
+	assert(std::find(parameters.begin(), parameters.end(), nullptr) == parameters.end());
+	return parameters;
 }
 
-std::vector<int> PositionEvaluation::GetParameters()
+bool PositionEvaluation::LoadParameters(const std::vector<int>& parameters)
 {
-	std::vector<int> parameters = {
-	BishopPairBonus,
-	CastlingBonus,
-
-	CenterPawnBonus,
-	DoubledPawnPunishment,
-	IsolatedPawnPunishment,
-	BackwardsPawnPunishment,
-	PassedPawnBonus,
-	AdvancedPawnBonus[0],
-	AdvancedPawnBonus[1],
-	AdvancedPawnBonus[2],
-	SquareBehindPawnBonus,
+	const bool hasPieceSquareTables = (parameters.size() == NumberOfScalarParameters + 2 * 6 * 64);
+	if (parameters.size() != NumberOfScalarParameters && !hasPieceSquareTables)
+		return false;
+
+	const std::array<int*, NumberOfScalarParameters> scalarParameters = GetScalarParameters(TunableParameters::Values);
+	for (size_t i = 0; i < NumberOfScalarParameters; i++)
+		*scalarParameters[i] = parameters[i];
+	UseTunableParameters = true;
+	ParametersVersion++;
+
+	//piece-square tables, middlegame then endgame, optional
+	if (hasPieceSquareTables)
+	{
+		size_t idx = NumberOfScalarParameters;
+		for (PieceSquareTables::Table* table : { &PieceSquareTables::GetMiddlegameTable(), &PieceSquareTables::GetEndgameTable() })
+			for (std::array<int, 64>& values : *table)
+				for (int& value : values)
+					value = parameters[idx++];
+	}
 
-	KnightEndgamePunishment,
-	BishopEndgamePunishment,
+	return true;
+}
 
-	RookOnSemiOpenFileBonus,
-	RookOnOpenFileBonus,
+bool PositionEvaluation::LoadParameters(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+		return false;
 
-	Blocking_d_or_ePawnPunishment,
+	std::vector<int> parameters;
+	int parameter = 0;
+	while (file >> parameter)
+	{
+		parameters.push_back(parameter);
+		char separator = ',';
+		if (!(file >> separator))
+			break;
+		if (separator != ',')
+			return false;
+	}
 
-	KnightPawnBonus,
-	BishopPawnPunishment,
-	RookPawnPunishment,
+	//stream stops before end of file on a non numeric value
+	return file.eof() && LoadParameters(parameters);
+}
 
-	AttackedSquareBonusFactor,
-	CenterAttackedBonusFactor,
-	KingSquaresAttackBonusFactor,
+std::vector<int> PositionEvaluation::GetParameters()
+{
+	//tunable parameters are kept equal to default parameters until parameters are loaded
+	std::vector<int> parameters;
+	for (const int* parameter : GetScalarParameters(TunableParameters::Values))
+		parameters.push_back(*parameter);
 
-	SamePieceTwicePunishment,
-	TempoBonus };
+	for (const PieceSquareTables::Table* table : { &PieceSquareTables::GetMiddlegameTable(), &PieceSquareTables::GetEndgameTable() })
+		for (const std::array<int, 64>& values : *table)
+			parameters.insert(parameters.end(), values.begin(), values.end());
 
 	return parameters;
 }
 
 void PositionEvaluation::InitParameters()
 {
-	BishopPairBonus = 15;
-	CastlingBonus = 50;
+	TunableParameters::Values = DefaultParameters::Values;
+	UseTunableParameters = false;
+	ParametersVersion++;
+
+	PieceSquareTables::Reset();
+}
 
-	CenterPawnBonus = 40;
-	DoubledPawnPunishment = -20;
-	IsolatedPawnPunishment = -40;
-	BackwardsPawnPunishment = -20;
-	PassedPawnBonus = 40;
-	AdvancedPawnBonus = { 30, 40, 50 };
-	SquareBehindPawnBonus = 1;
+int PositionEvaluation::GetGamePhase(const Position& position)
+{
+	return UseTunableParameters ? GetMaterialEntry<TunableParameters>(position).m_GamePhase : GetMaterialEntry<DefaultParameters>(position).m_GamePhase;
+}
 
-	KnightEndgamePunishment = -10;
-	BishopEndgamePunishment = 10;
+template<class Parameters>
+const MaterialTableEntry& PositionEvaluation::GetMaterialEntry(const Position& position)
+{
+	const EvaluationParameters& weights = Parameters::Values;
 
-	RookOnSemiOpenFileBonus = 20;
-	RookOnOpenFileBonus = 30;
+	ClearOutdatedCaches();
 
-	Blocking_d_or_ePawnPunishment = -40;
+	MaterialTableEntry& entry = MaterialCache[position.GetMaterialKey()];
+	if (entry.m_MaterialKey == position.GetMaterialKey())
+		return entry;
 
-	KnightPawnBonus = 2;
-	BishopPawnPunishment = -2;
-	RookPawnPunishment = -2;
+	entry.m_MaterialKey = position.GetMaterialKey();
+	const int allPawnsCount = position.GetPieceCount(PieceType::Pawn, true) + position.GetPieceCount(PieceType::Pawn, false);
+	std::array<int, 2> nonPawnMaterial = {}; //white, black
+	entry.m_Score = 0;
+	entry.m_GamePhase = 0;
+	for (bool isWhite : { true, false })
+	{
+		const int knights = position.GetPieceCount(PieceType::Knight, isWhite);
+		const int bishops = position.GetPieceCount(PieceType::Bishop, isWhite);
+		const int rooks = position.GetPieceCount(PieceType::Rook, isWhite);
+		const int queens = position.GetPieceCount(PieceType::Queen, isWhite);
+
+		//Bishop pair bonus, piece type bonus according to number of pawns left
+		int score = (bishops >= 2 ? weights.m_BishopPairBonus : 0);
+		score += allPawnsCount * (knights * weights.m_KnightPawnBonus + bishops * weights.m_BishopPawnPunishment + rooks * weights.m_RookPawnPunishment);
+		entry.m_Score += (isWhite ? score : -score);
+
+		entry.m_GamePhase += knights + bishops + 2 * rooks + 4 * queens;
+		nonPawnMaterial[isWhite ? 0 : 1] = knights * GetPieceValue(PieceType::Knight) + bishops * GetPieceValue(PieceType::Bishop) +
+			rooks * GetPieceValue(PieceType::Rook) + queens * GetPieceValue(PieceType::Queen);
+	}
+	entry.m_GamePhase = std::min(entry.m_GamePhase, MaxGamePhase); //promotions may exceed initial material
 
-	AttackedSquareBonusFactor = 0;
-	CenterAttackedBonusFactor = 1;
-	KingSquaresAttackBonusFactor = 5;
+	//Without pawns, a side less than a bishop ahead can hardly win, and can't without at least a rook worth of material
+	for (bool isWhite : { true, false })
+	{
+		const int ownMaterial = nonPawnMaterial[isWhite ? 0 : 1];
+		const int enemyMaterial = nonPawnMaterial[isWhite ? 1 : 0];
+		int scaleFactor = NormalScaleFactor;
+		if ((position.GetPieceCount(PieceType::Pawn, isWhite) == 0) && (ownMaterial - enemyMaterial <= GetPieceValue(PieceType::Bishop)))
+			scaleFactor = (ownMaterial < GetPieceValue(PieceType::Rook)) ? 0 : (enemyMaterial <= GetPieceValue(PieceType::Bishop) ? 4 : 14);
+		(isWhite ? entry.m_WhiteScaleFactor : entry.m_BlackScaleFactor) = scaleFactor;
+	}
 
-	SamePieceTwicePunishment = -50;
-	TempoBonus = 30;
+	entry.m_IsBishopsEnding = (position.GetPieceCount(PieceType::Bishop, true) == 1) && (position.GetPieceCount(PieceType::Bishop, false) == 1) &&
+		(nonPawnMaterial[0] == GetPieceValue(PieceType::Bishop)) && (nonPawnMaterial[1] == GetPieceValue(PieceType::Bishop));
+
+	return entry;
+}
+
+int PositionEvaluation::GetScaleFactor(const Position& position, const MaterialTableEntry& material, bool isWhiteAhead)
+{
+	int scaleFactor = (isWhiteAhead ? material.m_WhiteScaleFactor : material.m_BlackScaleFactor);
+
+	//bishop colors aren't part of material key
+	if (material.m_IsBishopsEnding && (((position.GetWhiteBishops() & LightSquares) != 0) != ((position.GetBlackBishops() & LightSquares) != 0)))
+		scaleFactor = std::min(scaleFactor, OppositeBishopsScaleFactor);
+
+	return scaleFactor;
 }
 
 int PositionEvaluation::CountMaterial(const Position& position, bool isWhite)
@@ -288,33 +388,6 @@ int PositionEvaluation::CountMaterial(const Position& position, bool isWhite)
 	return material;
 }
 
-constexpr int PositionEvaluation::GetPieceValue(PieceType type)
-{
-	int value = 0;
-	switch (type)
-	{
-	case PieceType::Queen:
-		value = 900;
-		break;
-	case PieceType::Rook:
-		value = 490;
-		break;
-	case PieceType::Bishop:
-		value = 320;
-		break;
-	case PieceType::Knight:
-		value = 290;
-		break;
-	case PieceType::Pawn:
-		value = 100;
-		break;
-	default:
-		break;
-	}
-
-	return value;
-}
-
 int PositionEvaluation::GetUndevelopedPiecesPunishment(const Position& position, bool isWhite)
 {
 	const Bitboard undevelopedKnights = (isWhite ? (position.GetWhiteKnights() & (_b1 | _g1)) : (position.GetBlackKnights() & (_b8 | _g8)));
@@ -324,19 +397,62 @@ int PositionEvaluation::GetUndevelopedPiecesPunishment(const Position& position,
 	return -(undevelopedKnights.CountSetBits() * 10 + undevelopedBishops.CountSetBits() * 10 + undevelopedRooks.CountSetBits() * 5 + undevelopedQueen.CountSetBits() * 5);
 }
 
+template<class Parameters>
+const PawnHashTableEntry& PositionEvaluation::GetPawnStructure(const Position& position)
+{
+	const EvaluationParameters& weights = Parameters::Values;
+
+	ClearOutdatedCaches();
+
+	PawnHashTableEntry& entry = PawnTable[position.GetPawnHash()];
+	if (entry.m_PawnHash == position.GetPawnHash())
+		return entry;
+
+	int score = 0;
+
+	//Center pawns bonus
+	score += CountCenterPawns(position, true) * weights.m_CenterPawnBonus;
+	score -= CountCenterPawns(position, false) * weights.m_CenterPawnBonus;
+
+	//Double pawn punishment
+	score += CountDoubledPawns(position, true) * weights.m_DoubledPawnPunishment;
+	score -= CountDoubledPawns(position, false) * weights.m_DoubledPawnPunishment;
+
+	//Isolated pawn punishment
+	score += CountIsolatedPawns(position, true) * weights.m_IsolatedPawnPunishment;
+	score -= CountIsolatedPawns(position, false) * weights.m_IsolatedPawnPunishment;
+
+	//Backwards pawn punishment
+	score += CountBackwardsPawns(position, true) * weights.m_BackwardsPawnPunishment;
+	score -= CountBackwardsPawns(position, false) * weights.m_BackwardsPawnPunishment;
+
+	//Passed pawn bonus
+	entry.m_WhitePassedPawns = GetPassedPawns(position, true);
+	entry.m_BlackPassedPawns = GetPassedPawns(position, false);
+	score += entry.m_WhitePassedPawns.CountSetBits() * weights.m_PassedPawnBonus;
+	score -= entry.m_BlackPassedPawns.CountSetBits() * weights.m_PassedPawnBonus;
+
+	//Advanced pawns bonus
+	score += GetAdvancedPawnsBonus<Parameters>(position, true);
+	score -= GetAdvancedPawnsBonus<Parameters>(position, false);
+
+	//Space
+	score += GetSpaceBehindPawns(position, true) * weights.m_SquareBehindPawnBonus;
+	score -= GetSpaceBehindPawns(position, false) * weights.m_SquareBehindPawnBonus;
+
+	entry.m_PawnHash = position.GetPawnHash();
+	entry.m_Score = score;
+	entry.m_WhitePawnFiles = FileFill(position.GetWhitePawns());
+	entry.m_BlackPawnFiles = FileFill(position.GetBlackPawns());
+	return entry;
+}
+
 int PositionEvaluation::CountDoubledPawns(const Position& position, bool isWhite)
 {
-	int count = 0;
+	//pawns with another pawn in front or behind
 	const Bitboard& pawns = isWhite ? position.GetWhitePawns() : position.GetBlackPawns();
-	for (int i = 0; i < 8; i++)
-	{
-		Bitboard file = pawns & _files[i];
-		int countOnFile = file.CountSetBits();
-		if (countOnFile > 1)
-			count += countOnFile;
-	}
-
-	return count;
+	const Bitboard doubledPawns = pawns & (NorthFill(pawns << 8) | SouthFill(pawns >> 8));
+	return doubledPawns.CountSetBits();
 }
 
 int PositionEvaluation::CountCenterPawns(const Position& position, bool isWhite)
@@ -351,106 +467,48 @@ int PositionEvaluation::CountCenterPawns(const Position& position, bool isWhite)
 
 int PositionEvaluation::CountIsolatedPawns(const Position& position, bool isWhite)
 {
-	int count = 0;
+	//pawns without friend pawns on side files
 	const Bitboard& pawns = isWhite ? position.GetWhitePawns() : position.GetBlackPawns();
-	for (int i = 0; i <= 7; i++)
-	{
-		Bitboard sideBySideFiles = _files[i]; //up to 3 files
-		if (i > 0)
-			sideBySideFiles |= _files[i - 1];
-		if (i < 7)
-			sideBySideFiles |= _files[i + 1];
-
-		const Bitboard pawnsOnFile = pawns & _files[i];
-		const Bitboard pawnsOnSideBySideFiles = pawns & sideBySideFiles;
-		const int countOnFile = pawnsOnFile.CountSetBits();
-		if (countOnFile == pawnsOnSideBySideFiles.CountSetBits())
-			count += countOnFile;
-	}
-
-	return count;
+	const Bitboard isolatedPawns = pawns & ~SidesShift(FileFill(pawns));
+	return isolatedPawns.CountSetBits();
 }
 
 int PositionEvaluation::CountBackwardsPawns(const Position& position, bool isWhite)
 {
-	int count = 0;
+	//pawns on semi open files, without friend pawns behind or on the same rank on side files
 	const Bitboard& pawns = isWhite ? position.GetWhitePawns() : position.GetBlackPawns();
 	const Bitboard& enemyPawns = isWhite ? position.GetBlackPawns() : position.GetWhitePawns();
-	for (int i = 0; i <= 7; i++)
-	{
-		const Bitboard pawnsOnSemiOpenFile = pawns & (((enemyPawns & _files[i]) > 0) ? Bitboard() : _files[i]);
-		//check absence of friend pawns behind and on the sides
-		Bitboard sideFiles;
-		if (i > 0)
-			sideFiles |= _files[i - 1];
-		if (i < 7)
-			sideFiles |= _files[i + 1];
-
-		//loop over set bits
-		uint64_t bitset = pawnsOnSemiOpenFile;
-		while (bitset != 0)
-		{
-			const uint64_t t = bitset & (~bitset + 1);
-			const int idx = static_cast<int>(_tzcnt_u64(bitset));
-			const int row = idx >> 3;// or / 8
-
-			const Bitboard rowsBehind = (isWhite ? RowsUnder[row] : RowsAbove[row]); //includes pawns on same rank
-			const Bitboard pawnsBehind = (pawns & sideFiles & rowsBehind);
-			if (!pawnsBehind)
-				count++;
-
-			bitset ^= t;
-		}
-	}
-
-	return count;
+	const Bitboard supportedSquares = SidesShift(isWhite ? NorthFill(pawns) : SouthFill(pawns));
+	const Bitboard backwardsPawns = pawns & ~FileFill(enemyPawns) & ~supportedSquares;
+	return backwardsPawns.CountSetBits();
 }
 
 int PositionEvaluation::CountPassedPawns(const Position& position, bool isWhite)
 {
-	int count = 0;
+	return GetPassedPawns(position, isWhite).CountSetBits();
+}
+
+Bitboard PositionEvaluation::GetPassedPawns(const Position& position, bool isWhite)
+{
+	//pawns without enemy pawns in front, on same file or side files
 	const Bitboard& pawns = isWhite ? position.GetWhitePawns() : position.GetBlackPawns();
 	const Bitboard& enemyPawns = isWhite ? position.GetBlackPawns() : position.GetWhitePawns();
-	for (int i = 0; i <= 7; i++)
-	{
-		//check absence of enemy pawns in front and on the sides
-		const Bitboard pawnsOnFile = (pawns & _files[i]);
-		Bitboard sideBySideFiles = _files[i];
-		if (i > 0)
-			sideBySideFiles |= _files[i - 1];
-		if (i < 7)
-			sideBySideFiles |= _files[i + 1];
-		
-		//loop over set bits
-		uint64_t bitset = pawnsOnFile;
-		while (bitset != 0)
-		{
-			const uint64_t t = bitset & (~bitset + 1);
-			const int idx = static_cast<int>(_tzcnt_u64(bitset));
-			const int row = idx >> 3;// or / 8
-
-			assert((row + 1 < 8) && (row - 1 >= 0));
-			const Bitboard rowsInFront = (isWhite ? RowsAbove[row + 1] : RowsUnder[row - 1]);
-			const Bitboard blockingPawns = (sideBySideFiles & rowsInFront & enemyPawns); //doesn't include pawns on same rank
-			if (!blockingPawns)
-				count++;
-
-			bitset ^= t;
-		}
-	}
-
-	return count;
+	const Bitboard enemyFrontSpans = (isWhite ? SouthFill(enemyPawns >> 8) : NorthFill(enemyPawns << 8));
+	return pawns & ~(enemyFrontSpans | SidesShift(enemyFrontSpans));
 }
 
+template<class Parameters>
 int PositionEvaluation::GetAdvancedPawnsBonus(const Position& position, bool isWhite)
 {
+	const EvaluationParameters& weights = Parameters::Values;
+
 	int bonus = 0;
 	const Bitboard& pawns = isWhite ? position.GetWhitePawns() : position.GetBlackPawns();
 
 	for (int i = 4; i < 7; i++)
 	{
 		const int r = (isWhite ? i : 7 - i);
-		bonus += (pawns & _rows[r]).CountSetBits() * (isWhite ? AdvancedPawnBonus[i - 4] : -AdvancedPawnBonus[i - 4]);
+		bonus += (pawns & _rows[r]).CountSetBits() * (isWhite ? weights.m_AdvancedPawnBonus[i - 4] : -weights.m_AdvancedPawnBonus[i - 4]);
 	}
 
 	return bonus;
@@ -475,37 +533,61 @@ int PositionEvaluation::CountBlockedEorDPawns(const Position& position, bool isW
 
 int PositionEvaluation::GetSpaceBehindPawns(const Position& position, bool isWhite)
 {
-	int count = 0;
-	const Bitboard& allPawns = position.GetWhitePawns() | position.GetBlackPawns();
-	for (int i = 0; i <= 7; i++)
-	{
-		const Bitboard pawnsOnFile = (allPawns & _files[i]);
+	//squares behind rearmost pawn of each file with pawns
+	const Bitboard allPawns = position.GetWhitePawns() | position.GetBlackPawns();
+	const Bitboard space = FileFill(allPawns) & ~(isWhite ? NorthFill(allPawns) : SouthFill(allPawns));
+	return space.CountSetBits();
+}
 
-		//loop over set bits
-		uint64_t bitset = pawnsOnFile;
-		int lastPawnOnFile = (isWhite ? 7 : 0);
+template<class Parameters>
+PositionEvaluation::AttackInfo PositionEvaluation::GetAttackInfo(const Position& position, bool isWhite)
+{
+	const EvaluationParameters& weights = Parameters::Values;
+
+	AttackInfo info;
+	const Bitboard& ownPieces = (isWhite ? position.GetWhitePieces() : position.GetBlackPieces());
+	const Bitboard occupancy = position.GetWhitePieces() | position.GetBlackPieces();
+	const Bitboard& enemyKing = (isWhite ? position.GetBlackKing() : position.GetWhiteKing());
+	const Bitboard kingZone = MoveSearcher::GetMoveTable(PieceType::King)[enemyKing.GetSquare()] | enemyKing;
+
+	//pawns are done in one step, pawn controlled squares count even if occupied by own pieces
+	const Bitboard& pawns = (isWhite ? position.GetWhitePawns() : position.GetBlackPawns());
+	const Bitboard& enemyPawns = (isWhite ? position.GetBlackPawns() : position.GetWhitePawns());
+	info.m_AttackedSquares = (isWhite ? SidesShift(pawns) << 8 : SidesShift(pawns) >> 8);
+	const Bitboard enemyPawnAttacks = (isWhite ? SidesShift(enemyPawns) >> 8 : SidesShift(enemyPawns) << 8);
+	const Bitboard mobilityArea = ~(ownPieces | enemyPawnAttacks);
+
+	for (PieceType type : { PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen, PieceType::King })
+	{
+		uint64_t bitset = position.GetPiecesOfType(type, isWhite);
 		while (bitset != 0)
 		{
 			const uint64_t t = bitset & (~bitset + 1);
-			const int idx = static_cast<int>(_tzcnt_u64(bitset));
-			const int row = idx >> 3;// or / 8
-
-			lastPawnOnFile = (isWhite ? std::min(lastPawnOnFile, row) : std::max(lastPawnOnFile, row));
+			const Square square = static_cast<Square>(_tzcnt_u64(bitset));
+			const Bitboard attacks = MoveSearcher::GetAttacks(type, square, occupancy);
+			info.m_AttackedSquares |= attacks & ~ownPieces;
+
+			if (type != PieceType::King)
+			{
+				const int typeIdx = static_cast<int>(type) - 1;
+				info.m_Mobility += (attacks & mobilityArea).CountSetBits() * weights.m_MobilityBonus[typeIdx];
+				if ((attacks & kingZone) != 0)
+				{
+					info.m_KingAttackersCount++;
+					info.m_KingAttackersWeight += weights.m_KingAttackerWeight[typeIdx];
+				}
+			}
 
 			bitset ^= t;
 		}
-
-		if (lastPawnOnFile > 0 && lastPawnOnFile < 7)
-			count += (isWhite ? lastPawnOnFile : (7 - lastPawnOnFile));
 	}
 
-	return count;
+	return info;
 }
 
-Bitboard PositionEvaluation::GetAttackedSquares(Position& position, bool isWhite)
+Bitboard PositionEvaluation::GetAttackedSquares(const Position& position, bool isWhite)
 {
-	bool pawnControlledSquares = true;
-	return MoveSearcher::GetPseudoLegalSquaresFromBitboards(position, isWhite, pawnControlledSquares);
+	return GetAttackInfo<DefaultParameters>(position, isWhite).m_AttackedSquares; //attacked squares don't depend on parameters
 }
 
 Bitboard PositionEvaluation::GetAttackedSquaresAroundKing(const Position& position, const Bitboard& attackedSquares, bool isWhite)
@@ -517,26 +599,19 @@ Bitboard PositionEvaluation::GetAttackedSquaresAroundKing(const Position& positi
 
 std::pair<int, int> PositionEvaluation::CountRooksOnOpenFiles(const Position& position, bool isWhite)
 {
-	std::pair<int, int> result = { 0, 0 };
-	const Bitboard& rooks = (isWhite ? position.GetWhiteRooks() : position.GetBlackRooks());
-	Bitboard allPawns = position.GetWhitePawns() | position.GetBlackPawns();
-	const Bitboard& sameColorPawns = (isWhite ? position.GetWhitePawns() : position.GetBlackPawns());
-
-	//loop over set bits
-	uint64_t bitset = rooks;
-	while (bitset != 0)
-	{
-		const uint64_t t = bitset & (~bitset + 1);
-		const int idx = static_cast<int>(_tzcnt_u64(bitset));
+	return CountRooksOnOpenFiles(position, FileFill(position.GetWhitePawns()), FileFill(position.GetBlackPawns()), isWhite);
+}
 
-		const int file = idx & 7;// or % 8
-		if (!(_files[file] & allPawns))
-			result.first++;
-		else if (!(_files[file] & sameColorPawns))
-			result.second++;
+std::pair<int, int> PositionEvaluation::CountRooksOnOpenFiles(const Position& position, const Bitboard& whitePawnFiles, const Bitboard& blackPawnFiles, bool isWhite)
+{
+	const Bitboard& rooks = (isWhite ? position.GetWhiteRooks() : position.GetBlackRooks());
+	const Bitboard openFiles = ~(whitePawnFiles | blackPawnFiles);
+	const Bitboard semiOpenFiles = (isWhite ? (blackPawnFiles & ~whitePawnFiles) : (whitePawnFiles & ~blackPawnFiles));
 
-		bitset ^= t;
-	}
+	return { (rooks & openFiles).CountSetBits(), (rooks & semiOpenFiles).CountSetBits() };
+}
 
-	return result;
-}
\ No newline at end of file
+//Instantiations used outside of evaluation, by tests
+template int PositionEvaluation::EvaluateMaterial<DefaultParameters>(const Position& position);
+template const MaterialTableEntry& PositionEvaluation::GetMaterialEntry<DefaultParameters>(const Position& position);
+template PositionEvaluation::AttackInfo PositionEvaluation::GetAttackInfo<DefaultParameters>(const Position& position, bool isWhite);
\ No newline at end of file
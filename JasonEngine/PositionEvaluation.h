@@ -1,50 +1,170 @@
 #pragma once
 #include "Position.h"
+#include "PawnHashTable.h"
+#include "EvaluationCache.h"
+#include "MaterialTable.h"
+#include "EvaluationParameters.h"
 
 class PositionEvaluation
 {
 public:
 	/// <summary>Static evaluation of a position at depth 0, tactics/hanging pieces won't be taken into account</summary>
+	/// <param name="alpha">alpha-beta window from white point of view, positional terms are skipped if material score is far outside of it</param>
 	/// <returns>Score (>0 for white advantage, <0 for black), in centipawns</returns>
-	static int EvaluatePosition(Position& position, int ply);
+	static int EvaluatePosition(Position& position, int ply, int alpha = -Mate, int beta = Mate);
 
 	static bool IsPositionQuiet(const Position& position);
 
 	/// <returns>Number of moves (not plies) to mate</returns>
 	static std::optional<int> GetMovesToMate(int score);
 
-	static void LoadParameters(std::vector<int> parameters);
+	/// <summary>Load evaluation parameters, followed by middlegame and endgame piece-square tables (optional)</summary>
+	/// <remark>Evaluation then switches from compile time DefaultParameters to TunableParameters, until InitParameters is called.
+	/// Positions created before loading tables must recompute their piece-square scores</remark>
+	/// <returns>False if there are not as many parameters as GetParameters returns, with or without tables ; parameters are then unchanged</returns>
+	static bool LoadParameters(const std::vector<int>& parameters);
+	/// <summary>Load comma separated parameters, e.g. written by tuner</summary>
+	static bool LoadParameters(const std::string& path);
 	static std::vector<int> GetParameters();
 
+	/// <summary>Indices of scalar parameters in LoadParameters/GetParameters, arrays take consecutive indices ; piece-square tables follow</summary>
+	enum ParameterIndex : size_t
+	{
+		BishopPairBonusIndex,
+		CastlingBonusIndex,
+		CenterPawnBonusIndex,
+		DoubledPawnPunishmentIndex,
+		IsolatedPawnPunishmentIndex,
+		BackwardsPawnPunishmentIndex,
+		PassedPawnBonusIndex,
+		AdvancedPawnBonusIndex, //3 rows
+		SquareBehindPawnBonusIndex = AdvancedPawnBonusIndex + 3,
+		KnightEndgamePunishmentIndex,
+		BishopEndgamePunishmentIndex,
+		RookOnSemiOpenFileBonusIndex,
+		RookOnOpenFileBonusIndex,
+		Blocking_d_or_ePawnPunishmentIndex,
+		KnightPawnBonusIndex,
+		BishopPawnPunishmentIndex,
+		RookPawnPunishmentIndex,
+		AttackedSquareBonusFactorIndex,
+		CenterAttackedBonusFactorIndex,
+		KingSquaresAttackBonusFactorIndex,
+		SamePieceTwicePunishmentIndex,
+		TempoBonusIndex,
+		MobilityBonusIndex, //knight, bishop, rook, queen
+		KingAttackerWeightIndex = MobilityBonusIndex + 4, //knight, bishop, rook, queen
+		NumberOfScalarParameters = KingAttackerWeightIndex + 4
+	};
+
 	static int CountMaterial(const Position& position, bool isWhite);
 
-private:
-	static void InitParameters();
+	/// <returns>Game phase from remaining pieces, from MaxGamePhase (opening) to 0 (pawn endgame)</returns>
+	static int GetGamePhase(const Position& position);
 
 	/// <summary> Returns value in points of a given piece </summary>
 	static constexpr int GetPieceValue(PieceType type);
 
+private:
+	/// <summary>Reset default parameters, evaluation switches back to DefaultParameters</summary>
+	static void InitParameters();
+
+	/// <summary>Board evaluation with parameters policy, DefaultParameters or TunableParameters</summary>
+	template<class Parameters>
+	static int EvaluateBoard(Position& position, int alpha, int beta);
+
+	/// <summary>Tempo, material imbalance and piece-square values, cheap first part of board evaluation</summary>
+	template<class Parameters>
+	static int EvaluateMaterial(const Position& position);
+
+	/// <summary>Positional terms, second part of board evaluation</summary>
+	/// <remark>Board evaluation is independent of moves played to reach position, it is cached by zobrist hash</remark>
+	template<class Parameters>
+	static int EvaluatePositionalTerms(Position& position);
+
+	/// <summary>Evaluation terms depending on moves played to reach position, which zobrist hash doesn't account for</summary>
+	template<class Parameters>
+	static int EvaluateMovesHistory(const Position& position);
+
+	/// <summary>Clear caches of current thread if parameters changed since they were filled</summary>
+	static void ClearOutdatedCaches();
+
 	/// <returns>Punishment based on pieces dwelling on starting squares ; should not be applied during endgame</returns>
 	static int GetUndevelopedPiecesPunishment(const Position& position, bool isWhite);
 
+	/// <summary>Evaluation of piece counts: imbalance, game phase and endgame scale factors, probed from or stored in material table of current thread</summary>
+	template<class Parameters>
+	static const MaterialTableEntry& GetMaterialEntry(const Position& position);
+
+	/// <returns>Scale factor of endgame score for the side ahead, out of NormalScaleFactor</returns>
+	static int GetScaleFactor(const Position& position, const MaterialTableEntry& material, bool isWhiteAhead);
+
+	/// <summary>Evaluation of pawn-only terms, probed from or stored in pawn hash table of current thread</summary>
+	template<class Parameters>
+	static const PawnHashTableEntry& GetPawnStructure(const Position& position);
+
 	static int CountDoubledPawns(const Position& position, bool isWhite);
 	static int CountCenterPawns(const Position& position, bool isWhite);
 	static int CountIsolatedPawns(const Position& position, bool isWhite);
 	static int CountBackwardsPawns(const Position& position, bool isWhite);
 	static int CountPassedPawns(const Position& position, bool isWhite);
+	static Bitboard GetPassedPawns(const Position& position, bool isWhite);
+	template<class Parameters>
 	static int GetAdvancedPawnsBonus(const Position& position, bool isWhite);
 	static int CountBlockedEorDPawns(const Position& position, bool isWhite);
 
 	/// <returns>Returns number of squares behind pawns</returns>
 	static int GetSpaceBehindPawns(const Position& position, bool isWhite);
 
-	static Bitboard GetAttackedSquares(Position& position, bool isWhite);
+	/// <summary>Attacks of one color, computed in a single pass over its pieces</summary>
+	struct AttackInfo
+	{
+		Bitboard m_AttackedSquares; //squares attacked by pawns, or by pieces and not occupied by own pieces
+		int m_Mobility = 0; //mobility bonus of all pieces
+		int m_KingAttackersCount = 0; //number of pieces attacking squares around enemy king
+		int m_KingAttackersWeight = 0;
+	};
+
+	/// <remark>Sliding pieces attacks are generated once, and shared by mobility, king safety and center control terms</remark>
+	template<class Parameters>
+	static AttackInfo GetAttackInfo(const Position& position, bool isWhite);
+
+	static Bitboard GetAttackedSquares(const Position& position, bool isWhite);
 
 	/// <param name="attackedSquares">attacked squares by opposing color</param>
 	static Bitboard GetAttackedSquaresAroundKing(const Position& position, const Bitboard& attackedSquares, bool isWhiteKing);
 
 	/// <returns>Return number of rooks on open files and semi open files</returns>
 	static std::pair<int, int> CountRooksOnOpenFiles(const Position& position, bool isWhite);
+	/// <param name="whitePawnFiles">files with at least one white pawn</param>
+	static std::pair<int, int> CountRooksOnOpenFiles(const Position& position, const Bitboard& whitePawnFiles, const Bitboard& blackPawnFiles, bool isWhite);
 
 	friend class PositionEvaluationTests;
-};
\ No newline at end of file
+};
+
+constexpr int PositionEvaluation::GetPieceValue(PieceType type)
+{
+	int value = 0;
+	switch (type)
+	{
+	case PieceType::Queen:
+		value = 900;
+		break;
+	case PieceType::Rook:
+		value = 490;
+		break;
+	case PieceType::Bishop:
+		value = 320;
+		break;
+	case PieceType::Knight:
+		value = 290;
+		break;
+	case PieceType::Pawn:
+		value = 100;
+		break;
+	default:
+		break;
+	}
+
+	return value;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+/// <summary>Search and time management parameters which can be changed at runtime, e.g. for tuning ; each MoveMaker has its own set</summary>
+struct SearchParameters
+{
+	int m_AspirationWindowSize = 10; //half width of aspiration window around previous iteration score, in centipawns
+	int m_NullMoveReduction = 2; //reduced depth constant R of null move search
+	int m_ProbCutMargin = 200; //margin over beta a reduced depth search of a capture must reach for a ProbCut cutoff, in centipawns
+	int m_ProbCutMinDepth = 5;
+	int m_ProbCutDepthReduction = 4;
+	int m_InternalIterativeDepth = 4; //min depth for internal iterative deepening or reduction
+	int m_DeltaPruningMargin = 200; //safety margin for positional gains of a capture, in centipawns
+	int m_MoveTimePercent = 200; //time for a move, in percent of average time per move of remaining time
+	int m_NewIterationTimeFactor = 5; //don't start a new iteration if remaining time is under factor * last iteration duration
+
+	/// <returns>Parameter with given name, nullptr if there is none</returns>
+	int* Find(const std::string& name);
+
+	/// <summary>Set parameter with given name from text, clamped to its bounds</summary>
+	/// <returns>False if there is no such parameter or value isn't numeric, parameters are then unchanged</returns>
+	bool Set(const std::string& name, const std::string& value);
+};
+
+/// <summary>Name and bounds of a search parameter, bounds are used for tuning</summary>
+struct SearchParameterDescription
+{
+	const char* m_Name;
+	int SearchParameters::* m_Value;
+	int m_Min;
+	int m_Max;
+};
+
+static constexpr std::array<SearchParameterDescription, 9> SearchParameterDescriptions =
+{ {
+	{ "AspirationWindowSize", &SearchParameters::m_AspirationWindowSize, 5, 100 },
+	{ "NullMoveReduction", &SearchParameters::m_NullMoveReduction, 1, 4 },
+	{ "ProbCutMargin", &SearchParameters::m_ProbCutMargin, 50, 500 },
+	{ "ProbCutMinDepth", &SearchParameters::m_ProbCutMinDepth, 3, 10 },
+	{ "ProbCutDepthReduction", &SearchParameters::m_ProbCutDepthReduction, 2, 6 },
+	{ "InternalIterativeDepth", &SearchParameters::m_InternalIterativeDepth, 2, 10 },
+	{ "DeltaPruningMargin", &SearchParameters::m_DeltaPruningMargin, 50, 500 },
+	{ "MoveTimePercent", &SearchParameters::m_MoveTimePercent, 50, 400 },
+	{ "NewIterationTimeFactor", &SearchParameters::m_NewIterationTimeFactor, 1, 10 }
+} };
+
+/// <returns>Description of parameter with given name, nullptr if there is none</returns>
+inline const SearchParameterDescription* FindSearchParameterDescription(const std::string& name)
+{
+	for (const SearchParameterDescription& description : SearchParameterDescriptions)
+	{
+		if (name == description.m_Name)
+			return &description;
+	}
+
+	return nullptr;
+}
+
+inline int* SearchParameters::Find(const std::string& name)
+{
+	const SearchParameterDescription* description = FindSearchParameterDescription(name);
+	return description ? &(this->*description->m_Value) : nullptr;
+}
+
+inline bool SearchParameters::Set(const std::string& name, const std::string& value)
+{
+	const SearchParameterDescription* description = FindSearchParameterDescription(name);
+	if (!description)
+		return false;
+
+	try
+	{
+		this->*description->m_Value = std::clamp(std::stoi(value), description->m_Min, description->m_Max);
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -19,7 +19,7 @@ void TimeManager::SetMaxTime(double maxTime)
 
 	//we define what should be spent on move
 	m_MoveTime = std::min(maxTime,
-		0.5 * m_Increment + 2.0 * m_TotalTime * (m_TimeFactorByMove[std::min(m_MoveCount, static_cast<int>(m_TimeFactorByMove.size() - 1))] / m_TimeFactorsTotal));
+		0.5 * m_Increment + m_MoveTimeFactor * m_TotalTime * (m_TimeFactorByMove[std::min(m_MoveCount, static_cast<int>(m_TimeFactorByMove.size() - 1))] / m_TimeFactorsTotal));
 }
 
 void TimeManager::InitStartTime()
@@ -30,10 +30,14 @@ void TimeManager::InitStartTime()
 	QueryPerformanceCounter(&start);
 	m_CpuFreqKHz = cpuFreqKhz.QuadPart;
 	m_Start = start.QuadPart;
+	m_IsTimeOut = false;
 }
 
 bool TimeManager::IsTimeOut()
 {
+	if (m_IsTimeOut)
+		return true; //stays true until next search, so that whole search tree is left
+
 	m_CheckCount++; //only check every 1024 nodes
 	if (m_CheckCount < 1024)
 		return false;
@@ -43,10 +47,8 @@ bool TimeManager::IsTimeOut()
 	QueryPerformanceCounter(&time);
 	const double timeSpent = static_cast<double>(time.QuadPart - m_Start) / static_cast<double>(m_CpuFreqKHz); //in seconds
 
-	if (timeSpent > (m_MoveTime - 0.1))
-		return true;
-
-	return false;
+	m_IsTimeOut = (timeSpent > (m_MoveTime - 0.1));
+	return m_IsTimeOut;
 }
 
 bool TimeManager::HasTimeForNewIteration(double lastIterationDuration) const
@@ -55,8 +57,15 @@ bool TimeManager::HasTimeForNewIteration(double lastIterationDuration) const
 	QueryPerformanceCounter(&time);
 	const double timeSpent = static_cast<double>(time.QuadPart - m_Start) / static_cast<double>(m_CpuFreqKHz);
 	const double timeRemaining = m_MoveTime - timeSpent;
-	//dont start next iteration if remaining time < 5 * last iteration, this is a very rough guess...
-	return (timeRemaining > 5 * lastIterationDuration);
+	//dont start next iteration if remaining time < factor * last iteration, this is a very rough guess...
+	return (timeRemaining > m_NewIterationTimeFactor * lastIterationDuration);
+}
+
+double TimeManager::GetTimeSpent() const
+{
+	LARGE_INTEGER time;
+	QueryPerformanceCounter(&time);
+	return static_cast<double>(time.QuadPart - m_Start) / static_cast<double>(m_CpuFreqKHz);
 }
 
 void TimeManager::StartCounter()
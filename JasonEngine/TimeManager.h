@@ -13,6 +13,12 @@ public:
 
 	void SetIncrement(double increment) { m_Increment = increment; };
 
+	/// <summary>Time for a move is factor * average time per move of remaining time</summary>
+	void SetMoveTimeFactor(double factor) { m_MoveTimeFactor = factor; };
+
+	/// <summary>A new iteration isn't started if remaining time is under factor * last iteration duration</summary>
+	void SetNewIterationTimeFactor(double factor) { m_NewIterationTimeFactor = factor; };
+
 	void InitStartTime();
 
 	void SetMoveCount(int moveCount) { m_MoveCount = moveCount; }
@@ -21,6 +27,9 @@ public:
 
 	bool HasTimeForNewIteration(double lastIterationDuration) const;
 
+	/// <returns>Time spent since InitStartTime, in seconds</returns>
+	double GetTimeSpent() const;
+
 	void StartCounter();
 	void EndCounter();
 	double GetCounterDiff() const;
@@ -31,8 +40,11 @@ private:
 	double m_MoveTime = 0.0;
 
 	double m_Increment = 0.0;
+	double m_MoveTimeFactor = 2.0;
+	double m_NewIterationTimeFactor = 5.0;
 	int m_MoveCount = 0;
 	int m_CheckCount = 0;
+	bool m_IsTimeOut = false;
 
 	int64_t m_CpuFreqKHz = 0;
 	int64_t m_Start = 0;
@@ -19,6 +19,27 @@ public:
 	int16_t m_Score = 0;//16 bits
 	Move m_BestMove; //64 bits
 	//Total: 160... compiler makes it 192 (divisible by 64) so 24 bytes... it's huuuge
+
+	/// <summary>Set entry, hash is stored xor entry data so that entries torn by concurrent writes to a shared table don't match any position</summary>
+	void Store(uint64_t zobristHash, Flag flag, int depth, int score, const Move& bestMove)
+	{
+		m_Flag = flag;
+		m_Depth = static_cast<uint8_t>(depth);
+		m_Score = static_cast<int16_t>(score);
+		m_BestMove = bestMove;
+		m_ZobristHash = zobristHash ^ GetDataKey();
+	}
+
+	/// <returns>True if entry was stored for position of given hash</returns>
+	bool IsFor(uint64_t zobristHash) const { return (m_ZobristHash ^ GetDataKey()) == zobristHash; };
+
+private:
+	/// <returns>Whole move word xor score, depth and flag, so that a torn move word is detected too</returns>
+	uint64_t GetDataKey() const
+	{
+		const uint64_t data = static_cast<uint64_t>(static_cast<uint16_t>(m_Score)) | (static_cast<uint64_t>(m_Depth) << 16) | (static_cast<uint64_t>(m_Flag) << 24);
+		return m_BestMove.GetPackedMove() ^ ((data << 40) | (data >> 24));
+	}
 };
 
 static_assert(TranspositionTableSizeMb % sizeof(TranspositionTableEntry) == 0);
@@ -29,8 +50,12 @@ class TranspositionTable
 public:
 	TranspositionTable() { m_Table.reset(new TT); };
 	TranspositionTableEntry& operator[](size_t idx) { return (*m_Table)[idx]; };
+	const TranspositionTableEntry& operator[](size_t idx) const { return (*m_Table)[idx]; };
 	size_t size() const { return (*m_Table).size(); };
+
+	/// <summary>Use entries of another table, e.g. for concurrent searches ; table is freed with its last user</summary>
+	void Share(const TranspositionTable& table) { m_Table = table.m_Table; };
 private:
 	typedef std::array<TranspositionTableEntry, TranspositionTableSize> TT;
-	std::unique_ptr <std::array<TranspositionTableEntry, TranspositionTableSize>> m_Table;
+	std::shared_ptr<std::array<TranspositionTableEntry, TranspositionTableSize>> m_Table;
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "Engine.h"
+#include <iostream>
+
+InProcessEngine::InProcessEngine(const std::vector<std::pair<std::string, std::string>>& options)
+{
+	//values out of bounds are clamped like with UCI setoption, non numeric values are skipped
+	for (const std::pair<std::string, std::string>& option : options)
+	{
+		if (FindSearchParameterDescription(option.first) && !m_SearchParameters.Set(option.first, option.second))
+			std::cout << "Invalid value " << option.second << " for " << option.first << ", option is skipped" << std::endl;
+	}
+
+	NewGame();
+}
+
+void InProcessEngine::NewGame()
+{
+	//new transposition table and history
+	m_MoveMaker = std::make_unique<MoveMaker>();
+	m_MoveMaker->SetSearchParameters(m_SearchParameters);
+}
+
+std::optional<Move> InProcessEngine::Go(const std::string& fen, const Position& position, const SearchLimits& limits, int& score)
+{
+	Position searchPosition = position;
+	int searchDepth = 0;
+	bool moveFound = false;
+	m_MoveMaker->SetNodeLimit(limits.m_Nodes);
+	if (limits.m_Nodes != 0)
+		moveFound = m_MoveMaker->MakeMove(3600.0, false, 0.0, searchPosition, MaxPvLength, score, searchDepth);
+	else
+	{
+		const double remainingTime = position.IsWhiteToPlay() ? limits.m_WhiteTime : limits.m_BlackTime;
+		moveFound = m_MoveMaker->MakeMove(remainingTime, false, limits.m_Increment, searchPosition, MaxPvLength, score, searchDepth);
+	}
+
+	if (!moveFound)
+		return std::nullopt;
+
+	//MoveMaker score is from white point of view
+	score = position.IsWhiteToPlay() ? score : -score;
+	return searchPosition.GetMoves().back();
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include "Position.h"
+#include "MoveMaker.h"
+#include "SearchParameters.h"
+
+/// <summary>Search limits of a move, either fixed nodes or remaining times with increment</summary>
+struct SearchLimits
+{
+	uint64_t m_Nodes = 0; //fixed nodes per move if not 0, times are ignored
+	double m_WhiteTime = 0.0; //remaining time, in seconds
+	double m_BlackTime = 0.0;
+	double m_Increment = 0.0; //time increment per move, in seconds
+};
+
+/// <summary>Engine playing games of a match</summary>
+class Engine
+{
+public:
+	virtual ~Engine() = default;
+
+	virtual void NewGame() = 0;
+
+	/// <summary>Find a move for position, reached from start FEN with moves of position</summary>
+	/// <param name="score">score for side to move, in centipawns</param>
+	/// <returns>Move, not applied ; nullopt if engine found no move (e.g. stopped)</returns>
+	virtual std::optional<Move> Go(const std::string& fen, const Position& position, const SearchLimits& limits, int& score) = 0;
+};
+
+/// <summary>Engine searching with a MoveMaker of this build, with its own search parameters</summary>
+class InProcessEngine : public Engine
+{
+public:
+	/// <param name="options">search parameters names and values, unknown names are ignored, values are clamped to parameter bounds</param>
+	InProcessEngine(const std::vector<std::pair<std::string, std::string>>& options);
+
+	void NewGame() override;
+	std::optional<Move> Go(const std::string& fen, const Position& position, const SearchLimits& limits, int& score) override;
+
+private:
+	SearchParameters m_SearchParameters;
+	std::unique_ptr<MoveMaker> m_MoveMaker;
+};
\ No newline at end of file
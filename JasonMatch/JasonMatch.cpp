@@ -0,0 +1,132 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <array>
+#include "Match.h"
+#include "UciEngine.h"
+
+static void PrintUsage()
+{
+	std::cout << "Usage: JasonMatch -engine1 <jason|uci engine path> -engine2 <jason|uci engine path> [-option1 Name=Value] [-option2 Name=Value]" << std::endl;
+	std::cout << "       [-openings file] [-games N] [-threads N] [-nodes N | -time seconds -increment seconds] [-elo0 E] [-elo1 E] [-alpha A] [-beta B]" << std::endl;
+	std::cout << "jason plays in process with this build, options are search parameters ; other engines are run as child processes, options are sent with setoption" << std::endl;
+	std::cout << "Openings file has one FEN per line, each opening is played with both colors" << std::endl;
+}
+
+/// <returns>FENs of openings file, move clocks are reset</returns>
+static std::vector<std::string> ReadOpenings(const std::string& path)
+{
+	std::vector<std::string> openings;
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		//board, side to play, castling rights and en passant square
+		std::istringstream stream(line);
+		std::string fen;
+		std::string field;
+		int fieldCount = 0;
+		while (fieldCount < 4 && (stream >> field))
+		{
+			fen += field + " ";
+			fieldCount++;
+		}
+
+		if (fieldCount == 4)
+			openings.push_back(fen + "0 1");
+	}
+
+	return openings;
+}
+
+static EngineFactory GetEngineFactory(const std::string& engine, const std::vector<std::pair<std::string, std::string>>& options)
+{
+	if (engine == "jason")
+		return [options]() { return std::make_unique<InProcessEngine>(options); };
+
+	return [engine, options]() { return std::make_unique<UciEngine>(engine, options); };
+}
+
+int main(int argc, char* argv[])
+{
+	MatchSettings settings;
+	settings.m_ThreadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	std::array<std::string, 2> engines;
+	std::array<std::vector<std::pair<std::string, std::string>>, 2> options;
+	std::string openingsPath;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (i + 1 >= argc)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		const std::string value = argv[++i];
+		if (argument == "-engine1" || argument == "-engine2")
+			engines[argument.back() - '1'] = value;
+		else if ((argument == "-option1" || argument == "-option2") && value.find('=') != std::string::npos)
+			options[argument.back() - '1'].emplace_back(value.substr(0, value.find('=')), value.substr(value.find('=') + 1));
+		else if (argument == "-openings")
+			openingsPath = value;
+		else if (argument == "-games")
+			settings.m_GameCount = std::stoi(value);
+		else if (argument == "-threads")
+			settings.m_ThreadCount = std::max(1, std::stoi(value));
+		else if (argument == "-nodes")
+			settings.m_Nodes = std::stoull(value);
+		else if (argument == "-time")
+			settings.m_Time = std::stod(value);
+		else if (argument == "-increment")
+			settings.m_Increment = std::stod(value);
+		else if (argument == "-elo0")
+			settings.m_Elo0 = std::stod(value);
+		else if (argument == "-elo1")
+			settings.m_Elo1 = std::stod(value);
+		else if (argument == "-alpha")
+			settings.m_Alpha = std::stod(value);
+		else if (argument == "-beta")
+			settings.m_Beta = std::stod(value);
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (engines[0].empty() || engines[1].empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	for (const std::string& engine : engines)
+	{
+		if ((engine != "jason") && !UciEngine(engine, {}).IsRunning())
+		{
+			std::cout << "Can't start " << engine << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<std::string> openings;
+	if (!openingsPath.empty())
+	{
+		openings = ReadOpenings(openingsPath);
+		if (openings.empty())
+		{
+			std::cout << "No opening read from " << openingsPath << std::endl;
+			return 1;
+		}
+	}
+
+	Match match(settings, GetEngineFactory(engines[0], options[0]), GetEngineFactory(engines[1], options[1]), openings);
+	match.Run();
+	std::cout << "Match over: +" << match.GetWins() << " =" << match.GetDraws() << " -" << match.GetLosses() << std::endl;
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "Match.h"
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+static const std::string StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+Match::Match(const MatchSettings& settings, const EngineFactory& firstEngine, const EngineFactory& secondEngine, const std::vector<std::string>& openings) :
+	m_Settings(settings), m_FirstEngine(firstEngine), m_SecondEngine(secondEngine), m_Openings(openings),
+	m_Sprt(settings.m_Elo0, settings.m_Elo1, settings.m_Alpha, settings.m_Beta)
+{
+	if (m_Openings.empty())
+		m_Openings.push_back(StartFen);
+}
+
+void Match::Run()
+{
+	std::vector<std::thread> threads;
+	for (int threadIdx = 0; threadIdx < m_Settings.m_ThreadCount; threadIdx++)
+		threads.emplace_back(&Match::RunThread, this);
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+void Match::RunThread()
+{
+	std::unique_ptr<Engine> firstEngine = m_FirstEngine();
+	std::unique_ptr<Engine> secondEngine = m_SecondEngine();
+	std::unique_ptr<MoveMaker> referee = std::make_unique<MoveMaker>();
+	while (true)
+	{
+		std::string fen;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_IsOver || (2 * m_NextGamePair >= m_Settings.m_GameCount))
+				return;
+
+			fen = m_Openings[m_NextGamePair % m_Openings.size()];
+			m_NextGamePair++;
+		}
+
+		const double firstResult = PlayGame(*firstEngine, *secondEngine, fen, m_Settings, *referee);
+		AddResult(firstResult);
+		const double secondResult = 1.0 - PlayGame(*secondEngine, *firstEngine, fen, m_Settings, *referee);
+		AddResult(secondResult);
+	}
+}
+
+double Match::PlayGame(Engine& white, Engine& black, const std::string& fen, const MatchSettings& settings, MoveMaker& referee)
+{
+	white.NewGame();
+	black.NewGame();
+
+	Position position(fen);
+	SearchLimits limits;
+	limits.m_Nodes = settings.m_Nodes;
+	limits.m_WhiteTime = settings.m_Time;
+	limits.m_BlackTime = settings.m_Time;
+	limits.m_Increment = settings.m_Increment;
+
+	return GameLoop::Play(position, settings.m_Adjudication, referee, [&](Position& gamePosition, int ply, int& whiteScore)
+	{
+		const bool isWhiteToPlay = gamePosition.IsWhiteToPlay();
+		Engine& engine = isWhiteToPlay ? white : black;
+		double& remainingTime = isWhiteToPlay ? limits.m_WhiteTime : limits.m_BlackTime;
+
+		int score = 0;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::optional<Move> move = engine.Go(fen, gamePosition, limits, score);
+		const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (!move.has_value() || !referee.MakeMove(gamePosition, *move))
+			return false;
+
+		if (settings.m_Nodes == 0)
+		{
+			remainingTime += settings.m_Increment - duration;
+			if (remainingTime < 0.0)
+				return false;
+		}
+
+		//engines report score for side which just played
+		whiteScore = isWhiteToPlay ? score : -score;
+		return true;
+	});
+}
+
+void Match::AddResult(double result)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (result > 0.75)
+		m_Wins++;
+	else if (result < 0.25)
+		m_Losses++;
+	else
+		m_Draws++;
+
+	PrintStatus();
+
+	const Sprt::Decision decision = m_Sprt.GetDecision(m_Sprt.GetLogLikelihoodRatio(m_Wins, m_Draws, m_Losses));
+	if (decision == Sprt::Decision::AcceptH1)
+	{
+		std::cout << "SPRT: H1 accepted, elo >= " << m_Settings.m_Elo1 << std::endl;
+		m_IsOver = true;
+	}
+	else if (decision == Sprt::Decision::AcceptH0)
+	{
+		std::cout << "SPRT: H0 accepted, elo <= " << m_Settings.m_Elo0 << std::endl;
+		m_IsOver = true;
+	}
+}
+
+void Match::PrintStatus() const
+{
+	const int gameCount = m_Wins + m_Draws + m_Losses;
+	const double score = (m_Wins + 0.5 * m_Draws) / gameCount;
+	const double variance = (m_Wins + 0.25 * m_Draws) / gameCount - score * score;
+	const double errorMargin = 1.96 * std::sqrt(std::max(variance, 0.0) / gameCount); //95% confidence
+	const double elo = Sprt::GetElo(score);
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "Games " << gameCount << ": +" << m_Wins << " =" << m_Draws << " -" << m_Losses;
+	std::cout << ", score " << 100.0 * score << "%, elo " << elo << " +/- " << (Sprt::GetElo(score + errorMargin) - elo);
+	std::cout << ", LLR " << m_Sprt.GetLogLikelihoodRatio(m_Wins, m_Draws, m_Losses) << " (" << m_Sprt.GetLowerBound() << ", " << m_Sprt.GetUpperBound() << ")" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Engine.h"
+#include "GameLoop.h"
+#include "Sprt.h"
+
+struct MatchSettings
+{
+	int m_GameCount = 1000; //max number of games, played in pairs with colors reversed from same opening
+	int m_ThreadCount = 1; //number of games played at the same time
+	uint64_t m_Nodes = 0; //fixed nodes per move if not 0, otherwise time + increment
+	double m_Time = 10.0; //time per game for each side, in seconds
+	double m_Increment = 0.1; //time increment per move, in seconds
+
+	AdjudicationSettings m_Adjudication = { 1000, 6, 10, 20, 80 }; //win score and plies, draw score, plies and min ply
+
+	double m_Elo0 = 0.0; //SPRT hypotheses and error probabilities
+	double m_Elo1 = 5.0;
+	double m_Alpha = 0.05;
+	double m_Beta = 0.05;
+};
+
+/// <summary>Creates an engine, each thread has its own engines</summary>
+using EngineFactory = std::function<std::unique_ptr<Engine>()>;
+
+/// <summary>Match between two engines, games are played in parallel until game count is reached or SPRT gives a verdict</summary>
+class Match
+{
+public:
+	/// <param name="openings">FENs of start positions, used in turn ; start position if empty</param>
+	Match(const MatchSettings& settings, const EngineFactory& firstEngine, const EngineFactory& secondEngine, const std::vector<std::string>& openings);
+
+	void Run();
+
+	/// <summary>Results of first engine</summary>
+	int GetWins() const { return m_Wins; };
+	int GetDraws() const { return m_Draws; };
+	int GetLosses() const { return m_Losses; };
+
+	/// <summary>Play a game from FEN, adjudicated on agreed evaluations, insufficient material and max length</summary>
+	/// <param name="referee">move maker checking moves legality and game end</param>
+	/// <returns>Result for white: 1 for a win, 0.5 for a draw, 0 for a loss (including illegal move and time out)</returns>
+	static double PlayGame(Engine& white, Engine& black, const std::string& fen, const MatchSettings& settings, MoveMaker& referee);
+
+private:
+	/// <summary>Play game pairs on one thread until match is over</summary>
+	void RunThread();
+
+	/// <summary>Add result of first engine and check SPRT, under mutex</summary>
+	void AddResult(double result);
+	void PrintStatus() const;
+
+	MatchSettings m_Settings;
+	EngineFactory m_FirstEngine;
+	EngineFactory m_SecondEngine;
+	std::vector<std::string> m_Openings;
+	Sprt m_Sprt;
+
+	std::mutex m_Mutex; //protects members below
+	int m_NextGamePair = 0;
+	bool m_IsOver = false;
+	int m_Wins = 0;
+	int m_Draws = 0;
+	int m_Losses = 0;
+};
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "Sprt.h"
+#include <cmath>
+#include <algorithm>
+
+Sprt::Sprt(double elo0, double elo1, double alpha, double beta)
+{
+	m_Score0 = GetScore(elo0);
+	m_Score1 = GetScore(elo1);
+	m_LowerBound = std::log(beta / (1.0 - alpha));
+	m_UpperBound = std::log((1.0 - beta) / alpha);
+}
+
+double Sprt::GetLogLikelihoodRatio(int wins, int draws, int losses) const
+{
+	const int gameCount = wins + draws + losses;
+	if (gameCount == 0)
+		return 0.0;
+
+	const double winRatio = static_cast<double>(wins) / gameCount;
+	const double drawRatio = static_cast<double>(draws) / gameCount;
+	const double score = winRatio + 0.5 * drawRatio;
+	const double variance = winRatio + 0.25 * drawRatio - score * score;
+	if (variance <= 0.0)
+		return 0.0;
+
+	//log likelihood ratio of normal distributions with same variance, centered on both hypotheses
+	const double scoreVariance = variance / gameCount;
+	return (m_Score1 - m_Score0) * (2.0 * score - m_Score0 - m_Score1) / (2.0 * scoreVariance);
+}
+
+Sprt::Decision Sprt::GetDecision(double logLikelihoodRatio) const
+{
+	if (logLikelihoodRatio >= m_UpperBound)
+		return Decision::AcceptH1;
+	else if (logLikelihoodRatio <= m_LowerBound)
+		return Decision::AcceptH0;
+
+	return Decision::Continue;
+}
+
+double Sprt::GetElo(double score)
+{
+	score = std::clamp(score, 0.001, 0.999);
+	return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double Sprt::GetScore(double elo)
+{
+	return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+/// <summary>
+/// Sequential probability ratio test between hypotheses H0: elo = elo0 and H1: elo = elo1,
+/// with normal approximation of the game score distribution
+/// </summary>
+class Sprt
+{
+public:
+	/// <param name="alpha">probability of accepting H1 when H0 is true</param>
+	/// <param name="beta">probability of accepting H0 when H1 is true</param>
+	Sprt(double elo0, double elo1, double alpha, double beta);
+
+	/// <returns>Log likelihood ratio of H1 over H0, 0 until there is some variance in results</returns>
+	double GetLogLikelihoodRatio(int wins, int draws, int losses) const;
+
+	/// <summary>H0 is accepted under lower bound, H1 is accepted over upper bound</summary>
+	double GetLowerBound() const { return m_LowerBound; };
+	double GetUpperBound() const { return m_UpperBound; };
+
+	enum class Decision { Continue, AcceptH0, AcceptH1 };
+
+	/// <returns>Hypothesis accepted once log likelihood ratio reaches a bound, bounds included</returns>
+	Decision GetDecision(double logLikelihoodRatio) const;
+
+	/// <returns>Elo difference for a score from 0 to 1</returns>
+	static double GetElo(double score);
+
+	/// <returns>Expected score from 0 to 1 for an elo difference</returns>
+	static double GetScore(double elo);
+
+private:
+	double m_Score0 = 0.5;
+	double m_Score1 = 0.5;
+	double m_LowerBound = 0.0;
+	double m_UpperBound = 0.0;
+};
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "UciEngine.h"
+#include "NotationParser.h"
+#include "PositionEvaluation.h"
+#include <sstream>
+#include <array>
+
+UciEngine::UciEngine(const std::string& path, const std::vector<std::pair<std::string, std::string>>& options)
+{
+	//pipes for engine standard input and output, only child ends are inherited
+	SECURITY_ATTRIBUTES securityAttributes = {};
+	securityAttributes.nLength = sizeof(SECURITY_ATTRIBUTES);
+	securityAttributes.bInheritHandle = TRUE;
+	HANDLE inputRead = nullptr;
+	HANDLE outputWrite = nullptr;
+	if (!CreatePipe(&inputRead, &m_InputWrite, &securityAttributes, 0) || !CreatePipe(&m_OutputRead, &outputWrite, &securityAttributes, 0))
+		return;
+	SetHandleInformation(m_InputWrite, HANDLE_FLAG_INHERIT, 0);
+	SetHandleInformation(m_OutputRead, HANDLE_FLAG_INHERIT, 0);
+
+	STARTUPINFOA startupInfo = {};
+	startupInfo.cb = sizeof(STARTUPINFOA);
+	startupInfo.hStdInput = inputRead;
+	startupInfo.hStdOutput = outputWrite;
+	startupInfo.hStdError = outputWrite;
+	startupInfo.dwFlags = STARTF_USESTDHANDLES;
+	PROCESS_INFORMATION processInformation = {};
+	std::string commandLine = "\"" + path + "\"";
+	m_IsRunning = CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &startupInfo, &processInformation);
+	CloseHandle(inputRead);
+	CloseHandle(outputWrite);
+	if (!m_IsRunning)
+		return;
+
+	m_Process = processInformation.hProcess;
+	CloseHandle(processInformation.hThread);
+
+	Send("uci");
+	WaitFor("uciok");
+	for (const std::pair<std::string, std::string>& option : options)
+		Send("setoption name " + option.first + " value " + option.second);
+}
+
+UciEngine::~UciEngine()
+{
+	if (m_IsRunning)
+	{
+		Send("quit");
+		if (WaitForSingleObject(m_Process, 1000) != WAIT_OBJECT_0)
+			TerminateProcess(m_Process, 1);
+	}
+
+	for (HANDLE handle : { m_Process, m_InputWrite, m_OutputRead })
+	{
+		if (handle != nullptr)
+			CloseHandle(handle);
+	}
+}
+
+void UciEngine::NewGame()
+{
+	Send("ucinewgame");
+	Send("isready");
+	WaitFor("readyok");
+}
+
+std::optional<Move> UciEngine::Go(const std::string& fen, const Position& position, const SearchLimits& limits, int& score)
+{
+	std::string command = "position fen " + fen;
+	if (!position.GetMoves().empty())
+	{
+		command += " moves";
+		for (const Move& move : position.GetMoves())
+			command += " " + NotationParser::TranslateToUciString(move);
+	}
+	Send(command);
+
+	if (limits.m_Nodes != 0)
+		Send("go nodes " + std::to_string(limits.m_Nodes));
+	else
+	{
+		Send("go wtime " + std::to_string(static_cast<int>(limits.m_WhiteTime * 1000.0)) + " btime " + std::to_string(static_cast<int>(limits.m_BlackTime * 1000.0))
+			+ " winc " + std::to_string(static_cast<int>(limits.m_Increment * 1000.0)) + " binc " + std::to_string(static_cast<int>(limits.m_Increment * 1000.0)));
+	}
+
+	//keep score of last info line
+	score = 0;
+	while (std::optional<std::string> line = ReadLine())
+	{
+		std::istringstream stream(*line);
+		std::string token;
+		stream >> token;
+		if (token == "bestmove")
+		{
+			std::string moveString;
+			stream >> moveString;
+			return NotationParser::TranslateFromUci(position, moveString);
+		}
+
+		while (stream >> token)
+		{
+			if (token == "cp")
+				stream >> score;
+			else if (token == "mate")
+			{
+				int movesToMate = 0;
+				stream >> movesToMate;
+				score = (movesToMate > 0) ? Mate - movesToMate : -Mate - movesToMate;
+			}
+		}
+	}
+
+	return std::nullopt;
+}
+
+void UciEngine::Send(const std::string& command)
+{
+	if (!m_IsRunning)
+		return;
+
+	const std::string line = command + "\n";
+	DWORD writtenCount = 0;
+	if (!WriteFile(m_InputWrite, line.data(), static_cast<DWORD>(line.size()), &writtenCount, nullptr))
+		m_IsRunning = false;
+}
+
+std::optional<std::string> UciEngine::ReadLine()
+{
+	std::array<char, 4096> buffer;
+	size_t endOfLine = m_Buffer.find('\n');
+	while (endOfLine == std::string::npos)
+	{
+		DWORD readCount = 0;
+		if (!m_IsRunning || !ReadFile(m_OutputRead, buffer.data(), static_cast<DWORD>(buffer.size()), &readCount, nullptr) || readCount == 0)
+		{
+			m_IsRunning = false;
+			return std::nullopt;
+		}
+
+		m_Buffer.append(buffer.data(), readCount);
+		endOfLine = m_Buffer.find('\n');
+	}
+
+	std::string line = m_Buffer.substr(0, endOfLine);
+	m_Buffer.erase(0, endOfLine + 1);
+	if (!line.empty() && line.back() == '\r')
+		line.pop_back();
+
+	return line;
+}
+
+std::optional<std::string> UciEngine::WaitFor(const std::string& prefix)
+{
+	while (std::optional<std::string> line = ReadLine())
+	{
+		if (line->compare(0, prefix.size(), prefix) == 0)
+			return line;
+	}
+
+	return std::nullopt;
+}
\ No newline at end of file
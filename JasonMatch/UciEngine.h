@@ -0,0 +1,36 @@
+#pragma once
+#include "Engine.h"
+
+#define NOMINMAX
+#include <windows.h>
+
+/// <summary>Engine running in a child process, e.g. another JasonUCI build, driven through UCI on its standard input and output</summary>
+class UciEngine : public Engine
+{
+public:
+	/// <param name="options">UCI options names and values, sent with setoption</param>
+	UciEngine(const std::string& path, const std::vector<std::pair<std::string, std::string>>& options);
+	~UciEngine() override;
+
+	/// <returns>False if process couldn't be started, or stopped answering</returns>
+	bool IsRunning() const { return m_IsRunning; };
+
+	void NewGame() override;
+	std::optional<Move> Go(const std::string& fen, const Position& position, const SearchLimits& limits, int& score) override;
+
+private:
+	void Send(const std::string& command);
+
+	/// <returns>Next line written by engine, nullopt if engine stopped</returns>
+	std::optional<std::string> ReadLine();
+
+	/// <summary>Read lines until one starts with prefix</summary>
+	/// <returns>Line starting with prefix, nullopt if engine stopped</returns>
+	std::optional<std::string> WaitFor(const std::string& prefix);
+
+	bool m_IsRunning = false;
+	HANDLE m_Process = nullptr;
+	HANDLE m_InputWrite = nullptr; //engine standard input
+	HANDLE m_OutputRead = nullptr; //engine standard output
+	std::string m_Buffer; //output read but not returned yet
+};
\ No newline at end of file
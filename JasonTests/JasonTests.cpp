@@ -4,6 +4,8 @@
 #include "PositionTests.h"
 #include "ZobristTests.h"
 #include "MoveMakerTests.h"
+#include "MatchTests.h"
+#include "TunerTests.h"
 #include "MoveSearcherTests.h"
 #include "PositionEvaluationTests.h"
 #include "TacticsTests.h"
@@ -21,6 +23,8 @@ int main()
     //PositionTests::Run();
     //ZobristTests::Run();
     //MoveMakerTests::Run();
+    //MatchTests::Run();
+    //TunerTests::Run();
     //MoveSearcherTests::Run();
     //PositionEvaluationTests::Run();
     TacticsTests::Run();
@@ -0,0 +1,109 @@
+#include "MatchTests.h"
+#include "TestsUtility.h"
+#include "JasonMatch/Match.h"
+#include <cmath>
+
+/// <summary>In process engine counting its searches</summary>
+class CountingEngine : public InProcessEngine
+{
+public:
+	CountingEngine() : InProcessEngine({}) {};
+
+	std::optional<Move> Go(const std::string& fen, const Position& position, const SearchLimits& limits, int& score) override
+	{
+		m_GoCount++;
+		return InProcessEngine::Go(fen, position, limits, score);
+	}
+
+	int m_GoCount = 0;
+};
+
+static void TestEngineScore()
+{
+	//engines report scores for side to move
+	const std::string blackToPlay = "4k3/8/8/8/8/8/8/QQ2K3 b - - 0 1";
+	SearchLimits limits;
+	limits.m_Nodes = 1000;
+	InProcessEngine engine({});
+	int score = 0;
+	ASSERT(engine.Go(blackToPlay, Position(blackToPlay), limits, score).has_value());
+	ASSERT(score <= -1000);
+
+	const std::string whiteToPlay = "4k3/8/8/8/8/8/8/QQ2K3 w - - 0 1";
+	ASSERT(engine.Go(whiteToPlay, Position(whiteToPlay), limits, score).has_value());
+	ASSERT(score >= 1000);
+
+	//invalid option values are skipped, out of bounds values are clamped
+	InProcessEngine optionsEngine({ { "ProbCutMargin", "wide" }, { "NullMoveReduction", "99" }, { "Unknown", "1" } });
+	ASSERT(optionsEngine.Go(whiteToPlay, Position(whiteToPlay), limits, score).has_value());
+}
+
+static void TestWinAdjudication()
+{
+	//both sides agree white is winning from first move, black to move
+	const std::string fen = "4k3/8/8/8/8/8/8/QQ2K3 b - - 0 1";
+	MatchSettings settings;
+	settings.m_Nodes = 1000;
+	settings.m_Adjudication.m_WinPlies = 2;
+	CountingEngine white;
+	CountingEngine black;
+	MoveMaker referee;
+	ASSERT(Match::PlayGame(white, black, fen, settings, referee) == 1.0);
+	ASSERT(black.m_GoCount == 1);
+	ASSERT(white.m_GoCount == 1);
+
+	//same game with colors of engines reversed
+	ASSERT(Match::PlayGame(black, white, fen, settings, referee) == 1.0);
+	ASSERT(white.m_GoCount == 2);
+	ASSERT(black.m_GoCount == 2);
+
+	//winning side changes in the middle of a streak, new streak starts at once
+	Adjudicator adjudicator({ 1000, 3 });
+	ASSERT(!adjudicator.Update(0, 1200).has_value());
+	ASSERT(!adjudicator.Update(1, 1100).has_value());
+	ASSERT(!adjudicator.Update(2, -1500).has_value());
+	ASSERT(!adjudicator.Update(3, -1500).has_value());
+	ASSERT(adjudicator.Update(4, -1500) == 0.0);
+
+	//streak is broken under win score
+	adjudicator = Adjudicator({ 1000, 2 });
+	ASSERT(!adjudicator.Update(0, 1200).has_value());
+	ASSERT(!adjudicator.Update(1, 900).has_value());
+	ASSERT(!adjudicator.Update(2, 1200).has_value());
+	ASSERT(adjudicator.Update(3, 1200) == 1.0);
+}
+
+static void TestSprt()
+{
+	const Sprt sprt(0.0, 10.0, 0.05, 0.05);
+	ASSERT(std::abs(sprt.GetLowerBound() - std::log(0.05 / 0.95)) < 1e-12);
+	ASSERT(std::abs(sprt.GetUpperBound() - std::log(0.95 / 0.05)) < 1e-12);
+
+	//60 wins, 20 draws, 20 losses: score 0.7, variance 0.6 + 0.25 * 0.2 - 0.7 * 0.7 = 0.16 per game
+	const double score1 = Sprt::GetScore(10.0);
+	const double expectedRatio = (score1 - 0.5) * (2.0 * 0.7 - 0.5 - score1) / (2.0 * 0.16 / 100.0);
+	ASSERT(std::abs(sprt.GetLogLikelihoodRatio(60, 20, 20) - expectedRatio) < 1e-9);
+	ASSERT(std::abs(expectedRatio - 1.7337) < 1e-3);
+
+	//results favouring elo1 are positive, results favouring elo0 are negative
+	ASSERT(sprt.GetLogLikelihoodRatio(20, 20, 60) < 0.0);
+	ASSERT(sprt.GetLogLikelihoodRatio(50, 0, 50) < 0.0); //elo 0 is closer than elo 10
+	ASSERT(sprt.GetLogLikelihoodRatio(52, 30, 48) > 0.0);
+	ASSERT(sprt.GetLogLikelihoodRatio(10, 0, 0) == 0.0); //no variance
+
+	//hypotheses are accepted on bounds
+	ASSERT(sprt.GetDecision(sprt.GetUpperBound()) == Sprt::Decision::AcceptH1);
+	ASSERT(sprt.GetDecision(std::nextafter(sprt.GetUpperBound(), 0.0)) == Sprt::Decision::Continue);
+	ASSERT(sprt.GetDecision(sprt.GetLowerBound()) == Sprt::Decision::AcceptH0);
+	ASSERT(sprt.GetDecision(std::nextafter(sprt.GetLowerBound(), 0.0)) == Sprt::Decision::Continue);
+	ASSERT(sprt.GetDecision(sprt.GetLogLikelihoodRatio(500, 300, 200)) == Sprt::Decision::AcceptH1);
+	ASSERT(sprt.GetDecision(sprt.GetLogLikelihoodRatio(200, 300, 500)) == Sprt::Decision::AcceptH0);
+	ASSERT(sprt.GetDecision(sprt.GetLogLikelihoodRatio(60, 20, 20)) == Sprt::Decision::Continue);
+}
+
+void MatchTests::Run()
+{
+	TestEngineScore();
+	TestWinAdjudication();
+	TestSprt();
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+class MatchTests
+{
+public:
+	static void Run();
+};
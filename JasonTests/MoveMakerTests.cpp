@@ -1,5 +1,8 @@
 #include "TestsUtility.h"
 #include "MoveMakerTests.h"
+#include "BatchAnalyzer.h"
+#include <algorithm>
+#include <tuple>
 
 void MoveMakerTests::Run()
 {
@@ -7,6 +10,96 @@ void MoveMakerTests::Run()
 	moveMakerTester.RunPrivate();
 }
 
+int MoveMakerTests::SearchFromRoot(Position& position, int depth, int alpha, int beta, std::optional<Move>& bestMove)
+{
+	m_TranspositionTable = {};
+	m_MoveHistory.Clear();
+	m_KillerMoves = {};
+	m_PrincipalVariation.clear();
+	m_NodeCount = 0;
+	m_NodeLimit = 0;
+	m_RootMoveCount = position.GetMoves().size();
+	m_TimeManager.SetMoveTime(3600.0);
+	m_TimeManager.InitStartTime();
+	return Search(position, depth, 0, alpha, beta, position.IsWhiteToPlay(), false, bestMove);
+}
+
+void MoveMakerTests::TestProbCut()
+{
+	SearchParameters probCut;
+	probCut.m_ProbCutMinDepth = 3;
+	SearchParameters noProbCut;
+	noProbCut.m_ProbCutMinDepth = MaxPly;
+
+	//same best moves of mates and tactics with and without ProbCut
+	const std::vector<std::tuple<std::string, int, Move>> tactics = {
+		{ "4k3/8/1Q2K3/8/8/8/8/8 w - - 0 1", 2, Move(PieceType::Queen, b6, b8) },
+		{ "r6k/6pp/3N4/8/2Q5/1B6/8/4K3 w - - 0 1", 3, Move(PieceType::Queen, c4, g8) },
+		{ "r7/p4kp1/1p2b3/5p1p/2PR1Pn1/3BP2P/PPQ2qP1/R1B4K b - - 2 26", 3, Move(PieceType::Queen, f2, e1) },
+		{ "5rk1/5pbp/6p1/8/8/2NQ4/1q4PP/5RK1 b - - 0 1", 3, Move(PieceType::Bishop, g7, c3) },
+		{ "3r2k1/1n3pp1/p3p1qp/P3P3/RprPN3/4Q2P/5PP1/1R4K1 b - - 4 28", 6, Move(PieceType::Rook, d8, d4) },
+		{ "1k1r4/p1pnb3/1nQ1p3/P7/3P4/4PN2/1P2KPq1/RN6 w - - 0 1", 6, Move(PieceType::Pawn, a5, a6) } };
+	for (const std::tuple<std::string, int, Move>& tactic : tactics)
+	{
+		for (const SearchParameters& parameters : { probCut, noProbCut })
+		{
+			SetSearchParameters(parameters);
+			m_TranspositionTable = {};
+			Position position(std::get<0>(tactic));
+			int score = 0;
+			MakeMove(position, std::get<1>(tactic), score);
+			ASSERT(position.GetMoves().back() == std::get<2>(tactic));
+		}
+	}
+
+	//capture of a hanging queen holds a reduced depth search over raised beta, cutoff before searching other moves
+	Position hangingQueen("4k3/pp6/8/3q4/8/8/PP1R4/4K3 w - - 0 1");
+	std::optional<Move> bestMove;
+	SetSearchParameters(noProbCut);
+	const int fullScore = SearchFromRoot(hangingQueen, 5, 99, 100, bestMove);
+	const uint64_t fullNodeCount = m_NodeCount;
+	SetSearchParameters(probCut);
+	const int probCutScore = SearchFromRoot(hangingQueen, 5, 99, 100, bestMove);
+	ASSERT(fullScore >= 100);
+	ASSERT(probCutScore >= 100 + probCut.m_ProbCutMargin);
+	ASSERT(m_NodeCount < fullNodeCount);
+
+	SetSearchParameters(SearchParameters());
+}
+
+void MoveMakerTests::TestInternalIterativeDeepening()
+{
+	SearchParameters internalIterativeDeepening;
+	internalIterativeDeepening.m_InternalIterativeDepth = 2;
+	SearchParameters noInternalIterativeDeepening;
+	noInternalIterativeDeepening.m_InternalIterativeDepth = MaxPly;
+
+	//without TT entries, the reduced depth search of PV nodes reuses the PV table and TT, but must not change best move nor PV of forced mates
+	const std::vector<std::tuple<std::string, int, Move>> positions = {
+		{ "r6k/6pp/3N4/8/2Q5/1B6/8/4K3 w - - 0 1", 4, Move(PieceType::Queen, c4, g8) },
+		{ "r7/p4kp1/1p2b3/5p1p/2PR1Pn1/3BP2P/PPQ2qP1/R1B4K b - - 2 26", 4, Move(PieceType::Queen, f2, e1) } };
+	for (const std::tuple<std::string, int, Move>& searchedPosition : positions)
+	{
+		Position position(std::get<0>(searchedPosition));
+		std::optional<Move> bestMove;
+		SetSearchParameters(noInternalIterativeDeepening);
+		const int score = SearchFromRoot(position, std::get<1>(searchedPosition), -Mate, Mate, bestMove);
+		const MoveList<MaxPvLength> principalVariation = m_PrincipalVariationTable[0];
+		ASSERT(bestMove.has_value() && (*bestMove == std::get<2>(searchedPosition)));
+		ASSERT(!principalVariation.empty() && (principalVariation[0] == std::get<2>(searchedPosition)));
+
+		std::optional<Move> iidBestMove;
+		SetSearchParameters(internalIterativeDeepening);
+		const int iidScore = SearchFromRoot(position, std::get<1>(searchedPosition), -Mate, Mate, iidBestMove);
+		ASSERT(iidScore == score);
+		ASSERT(iidBestMove == bestMove);
+		ASSERT(m_PrincipalVariationTable[0].size() == principalVariation.size());
+		ASSERT(std::equal(principalVariation.begin(), principalVariation.end(), m_PrincipalVariationTable[0].begin()));
+	}
+
+	SetSearchParameters(SearchParameters());
+}
+
 void MoveMakerTests::RunPrivate()
 {
 	//MVV-LVA tests
@@ -47,14 +140,30 @@ void MoveMakerTests::RunPrivate()
 	ASSERT(moves[1] == move7);
 	ASSERT((moves[2] == move3) || (moves[2] == move4));
 	//With transposition table lookup
-	moveMaker.m_TranspositionTable[moveMaker.GetTranspositionTableKey(position)].m_ZobristHash = position.GetZobristHash();
-	moveMaker.m_TranspositionTable[moveMaker.GetTranspositionTableKey(position)].m_BestMove = move8;
+	moveMaker.m_TranspositionTable[moveMaker.GetTranspositionTableKey(position)].Store(position.GetZobristHash(), TranspositionTableEntry::Flag::Exact, 0, 0, move8);
 	moveMaker.SortMoves(position, 0, moves);
 	ASSERT(moves[0] == move8);
 	ASSERT(moves[1] == move1);
 	ASSERT(moves[2] == move7);
 	ASSERT((moves[3] == move3) || (moves[3] == move4));
 
+	//History heuristic
+	position = Position("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+	Move noPreviousMove;
+	noPreviousMove.SetNullMove();
+	moveMaker.m_MoveHistory.Update(Move(PieceType::Rook, a1, a7), noPreviousMove, MoveList<MaxMoves>{ Move(PieceType::Rook, a1, a2) }, true, 4);
+	ASSERT(moveMaker.MovesSorter(position, 0, Move(PieceType::Rook, a1, a7), Move(PieceType::Rook, a1, a2)));
+	ASSERT(!moveMaker.MovesSorter(position, 0, Move(PieceType::Rook, a1, a2), Move(PieceType::Rook, a1, a7)));
+	ASSERT(moveMaker.MovesSorter(position, 0, Move(PieceType::Rook, a1, a3), Move(PieceType::Rook, a1, a2)));
+	moveMaker.m_MoveHistory.Clear();
+
+	//Principal variation of mate in 2
+	position = Position("4k3/8/1Q6/8/8/8/8/R3K3 w - - 0 1");
+	int pvScore = 0;
+	moveMaker.MakeMove(position, 3, pvScore);
+	ASSERT(moveMaker.GetPrincipalVariation().size() == 3);
+	ASSERT(moveMaker.GetPrincipalVariation().front() == position.GetMoves().back());
+
 	//Draw by repetition
 	position = Position("5k2/Q7/5K2/3N4/8/2n5/8/8 w - - 0 1");
 	Move move(PieceType::King, f6, e6);
@@ -135,14 +244,35 @@ void MoveMakerTests::RunPrivate()
 	//Same with an available transposition table entry whose best move should be discarded
 	moveMaker.m_TranspositionTable = {};
 	const size_t transpositionTableKey = moveMaker.GetTranspositionTableKey(positionCopy2);
-	moveMaker.m_TranspositionTable[transpositionTableKey].m_ZobristHash = positionCopy2.GetZobristHash();
-	moveMaker.m_TranspositionTable[transpositionTableKey].m_Score = 10000;
-	moveMaker.m_TranspositionTable[transpositionTableKey].m_Depth = 4;
-	moveMaker.m_TranspositionTable[transpositionTableKey].m_BestMove = Move(PieceType::Queen, a4, e8);
-	moveMaker.m_TranspositionTable[transpositionTableKey].m_Flag = TranspositionTableEntry::Flag::Exact;
+	moveMaker.m_TranspositionTable[transpositionTableKey].Store(positionCopy2.GetZobristHash(), TranspositionTableEntry::Flag::Exact, 4, 10000, Move(PieceType::Queen, a4, e8));
 	success = moveMaker.MakeMove(positionCopy2, 4, score);
 	ASSERT(positionCopy2.GetMoves().back().GetTo() != Piece(PieceType::Queen, e8));
 
+	//Entries torn by concurrent writes don't match: any change of the move word, including captures and backups, or of score, depth and flag
+	TranspositionTableEntry entry;
+	Move capture(PieceType::Queen, a4, e8);
+	capture.SetCapture(PieceType::Rook, e8);
+	entry.Store(positionCopy2.GetZobristHash(), TranspositionTableEntry::Flag::LowerBound, 4, 100, capture);
+	ASSERT(entry.IsFor(positionCopy2.GetZobristHash()));
+	ASSERT(!entry.IsFor(positionCopy.GetZobristHash() ^ 1));
+	for (int tornIdx = 0; tornIdx < 6; tornIdx++)
+	{
+		TranspositionTableEntry tornEntry = entry;
+		if (tornIdx == 0)
+			tornEntry.m_BestMove.SetCapture(PieceType::Knight, e8);
+		else if (tornIdx == 1)
+			tornEntry.m_BestMove.SetPliesFromLastIrreversibleMoveBackup(7);
+		else if (tornIdx == 2)
+			tornEntry.m_BestMove.SetCanBlackCastleQueenSideBackup(true);
+		else if (tornIdx == 3)
+			tornEntry.m_Score = -100;
+		else if (tornIdx == 4)
+			tornEntry.m_Depth = 5;
+		else
+			tornEntry.m_Flag = TranspositionTableEntry::Flag::Exact;
+		ASSERT(!tornEntry.IsFor(positionCopy2.GetZobristHash()));
+	}
+
 	//Same with null moves in between => count is reset, no draw ; best move is allowed
 	moveMaker.m_TranspositionTable = {};
 	move = Move();
@@ -152,4 +282,54 @@ void MoveMakerTests::RunPrivate()
 	success = moveMaker.MakeMove(positionCopy3, 4, score);
 	Piece to = positionCopy3.GetMoves().back().GetTo();
 	ASSERT(positionCopy3.GetMoves().back().GetTo() == Piece(PieceType::Queen, e8));
+
+	//Node limit stops search once first iteration is complete
+	Position startPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	moveMaker.m_TranspositionTable = {};
+	moveMaker.SetNodeLimit(2000);
+	success = moveMaker.MakeMove(startPosition, MaxPvLength, score);
+	ASSERT(success);
+	ASSERT(moveMaker.GetNodeCount() < 4000);
+	moveMaker.SetNodeLimit(0);
+
+	TestProbCut();
+	TestInternalIterativeDeepening();
+
+	//Search parameters by name
+	SearchParameters searchParameters;
+	ASSERT(searchParameters.Find("ProbCutMargin") == &searchParameters.m_ProbCutMargin);
+	ASSERT(searchParameters.Find("Unknown") == nullptr);
+	*searchParameters.Find("NullMoveReduction") = 3;
+	moveMaker.SetSearchParameters(searchParameters);
+	ASSERT(moveMaker.GetSearchParameters().m_NullMoveReduction == 3);
+
+	//values are clamped to parameter bounds, non numeric values and unknown names are rejected
+	ASSERT(searchParameters.Set("ProbCutMargin", "10000"));
+	ASSERT(searchParameters.m_ProbCutMargin == 500);
+	ASSERT(!searchParameters.Set("ProbCutMargin", "wide"));
+	ASSERT(searchParameters.m_ProbCutMargin == 500);
+	ASSERT(!searchParameters.Set("Unknown", "1"));
+
+	//Batch analysis reports each position once, with invalid positions, and scores for side to move
+	std::vector<AnalysisRequest> requests(5);
+	requests[0].m_Fen = "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1";
+	requests[0].m_Depth = 3;
+	requests[1].m_Fen = "7k/6Q1/6K1/8/8/8/8/8 b - - 0 1"; //checkmate
+	requests[2].m_Fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	requests[2].m_Nodes = 1000;
+	requests[3].m_Fen = "8/8/8/8/8/8/8/8 w - - 0 1";
+	requests[4].m_Fen = "r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1";
+	requests[4].m_Depth = 3;
+	std::vector<AnalysisResult> results(requests.size());
+	int resultCount = 0;
+	BatchAnalyzer analyzer(2, true);
+	analyzer.Analyze(requests, [&results, &resultCount](const AnalysisResult& result) { results[result.m_Index] = result; resultCount++; });
+	ASSERT(resultCount == 5);
+	ASSERT(results[0].m_IsValid && results[0].m_PrincipalVariation.front() == Move(PieceType::Rook, a1, a8));
+	ASSERT(results[0].m_Score > Mate - MaxPly);
+	ASSERT(!results[1].m_IsValid && results[1].m_PrincipalVariation.empty());
+	ASSERT(results[2].m_IsValid && results[2].m_NodeCount < 2000);
+	ASSERT(!results[3].m_IsValid);
+	ASSERT(results[4].m_IsValid && results[4].m_PrincipalVariation.front() == Move(PieceType::Rook, a8, a1));
+	ASSERT(results[4].m_Score > Mate - MaxPly);
 }
\ No newline at end of file
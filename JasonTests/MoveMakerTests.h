@@ -7,4 +7,11 @@ public:
 	static void Run();
 private:
 	void RunPrivate();
+
+	/// <summary>Search position from root at given depth and window, with empty transposition table and history</summary>
+	/// <returns>Score for side to move</returns>
+	int SearchFromRoot(Position& position, int depth, int alpha, int beta, std::optional<Move>& bestMove);
+
+	void TestProbCut();
+	void TestInternalIterativeDeepening();
 };
\ No newline at end of file
@@ -271,6 +271,49 @@ static void TestPawnMoves()
 	ASSERT(std::find(moves.begin(), moves.end(), Move(PieceType::Pawn, PieceType::Queen, b2, c1)) != moves.end());
 }
 
+static void TestCaptures()
+{
+	Position position("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1");
+	MoveSearcher::GetLegalCapturesFromBitboards(position, moves);
+	ASSERT(moves.size() == 1);
+	ASSERT(moves[0] == Move(PieceType::Pawn, e4, d5));
+
+	//en passant
+	position = Position("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+	MoveSearcher::GetLegalCapturesFromBitboards(position, moves);
+	ASSERT(moves.size() == 1);
+	ASSERT(moves[0] == Move(PieceType::Pawn, e5, d6));
+
+	//capturing promotions
+	position = Position("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+	MoveSearcher::GetLegalCapturesFromBitboards(position, moves);
+	ASSERT(moves.size() == 4);
+
+	//pinned piece can't capture
+	position = Position("4k3/4r3/8/3p4/4N3/8/8/4K3 w - - 0 1");
+	MoveSearcher::GetLegalCapturesFromBitboards(position, moves);
+	ASSERT(moves.empty());
+}
+
+static void TestStaticExchangeEvaluation()
+{
+	//undefended pawn
+	Position position("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1");
+	ASSERT(MoveSearcher::StaticExchangeEvaluation(position, Move(PieceType::Pawn, e4, d5)) == 100);
+
+	//rook takes pawn defended by pawn
+	position = Position("4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1");
+	ASSERT(MoveSearcher::StaticExchangeEvaluation(position, Move(PieceType::Rook, d1, d5)) == -400);
+
+	//x-ray recapture with rook behind
+	position = Position("4k3/8/2p5/3p4/8/8/3R4/3RK3 w - - 0 1");
+	ASSERT(MoveSearcher::StaticExchangeEvaluation(position, Move(PieceType::Rook, d2, d5)) == -300);
+
+	//equal trade
+	position = Position("4k3/8/2p5/3n4/8/4N3/8/4K3 w - - 0 1");
+	ASSERT(MoveSearcher::StaticExchangeEvaluation(position, Move(PieceType::Knight, e3, d5)) == 0);
+}
+
 static std::array<MoveList<MaxMoves>, PerftMaxDepth> perftMoveLists;
 void MoveSearcherTests::Run()
 {
@@ -281,6 +324,8 @@ void MoveSearcherTests::Run()
 	TestRookMoves();
 	TestBishopMoves();
 	TestIllegalCastles();
+	TestCaptures();
+	TestStaticExchangeEvaluation();
 
 	Position staleMateWhiteToPlay("8/8/8/8/8/kq6/8/K7 w - - 0 1");
 	Position staleMateBlackToPlay("8/8/8/8/8/KQ6/8/k7 b - - 0 1");
@@ -1,5 +1,7 @@
 #include "NotationParserTests.h"
 #include "Position.h"
+#include "NotationParser.h"
+#include "PgnReader.h"
 #include "TestsUtility.h"
 
 void NotationParserTests::Run()
@@ -53,4 +55,77 @@ void NotationParserTests::Run()
 	ASSERT(!positionB.CanBlackCastleKingSide() && !positionB.CanBlackCastleQueenSide());
 
 	ASSERT(enPassant1.GetEnPassantSquare() == c6);
+
+	//FEN round trip, including move clocks
+	std::array<char, NotationParser::MaxFENLength> buffer;
+	Position position;
+	for (std::string_view fen : { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 12 34", "8/8/8/8/8/8/8/8 b - - 0 1" })
+	{
+		ASSERT(NotationParser::ParseFEN(fen, position));
+		ASSERT(NotationParser::ToFEN(position, buffer) == fen);
+	}
+	ASSERT(NotationParser::ToFEN(Position(), buffer) == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+	//ranks must have exactly 8 squares, even when total is 64
+	for (std::string_view fen : { "p8/7/8/8/8/8/8/4K3 w - - 0 1", "4k3/8/8/2pP4/8/8/8/4K3/ w - - 0 1", "4k3/9/8/2pP4/8/8/8/4K3 w - - 0 1",
+		"4k2/8/8/2pP4/8/8/8/4K3/1 w - - 0 1", "4k3/8/8/2pP4/8/8/8/4K3pppppppp w - - 0 1", "4k44/8/8/2pP4/8/8/8/4K3 w - - 0 1", "4k3/8\xe9/8/2pP4/8/8/8/4K3 w - - 0 1" })
+		ASSERT(!NotationParser::ParseFEN(fen, position));
+	ASSERT(NotationParser::ToFEN(startingPositionEnPassant, buffer) == "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+
+	//reused position and moves played since FEN
+	ASSERT(NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4K3 b - - 3 40", position));
+	ASSERT(position.GetZobristHash() == Position("4k3/8/8/2pP4/8/8/8/4K3 b - - 3 40").GetZobristHash());
+	move = Move(PieceType::King, e8, e7);
+	position.Update(move);
+	ASSERT(NotationParser::ToFEN(position, buffer) == "8/4k3/8/2pP4/8/8/8/4K3 w - - 4 41");
+
+	//largest clock survives Update/Undo
+	ASSERT(NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4K3 b - - 255 40", position));
+	move = Move(PieceType::King, e8, e7);
+	position.Update(move);
+	ASSERT(NotationParser::ToFEN(position, buffer) == "8/4k3/8/2pP4/8/8/8/4K3 w - - 256 41");
+	position.Undo(move);
+	ASSERT(NotationParser::ToFEN(position, buffer) == "4k3/8/8/2pP4/8/8/8/4K3 b - - 255 40");
+
+	//invalid fields
+	ASSERT(!NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8 w - - 0 1", position));
+	ASSERT(!NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4K3 x - - 0 1", position));
+	ASSERT(!NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4X3 w - - 0 1", position));
+	ASSERT(!NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4K3 w - - 300 1", position)); //out of range clocks
+	ASSERT(!NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4K3 w - - 0 2000000000", position));
+	ASSERT(NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4K3 w - - 255 100000", position));
+	ASSERT(NotationParser::ParseFEN("4k3/8/8/2pP4/8/8/8/4K3 w - -", position));
+
+	//SAN: disambiguation, captures, promotions, castling and suffixes
+	Position sanPosition("r3k2r/1P6/8/8/8/2N3N1/8/R3K2R w KQkq - 0 1");
+	ASSERT(!NotationParser::TranslateFromSAN(sanPosition, "Ne4").has_value()); //ambiguous
+	ASSERT(NotationParser::TranslateFromSAN(sanPosition, "Nce4") == Move(PieceType::Knight, c3, e4));
+	ASSERT(NotationParser::TranslateFromSAN(sanPosition, "Nge4+") == Move(PieceType::Knight, g3, e4));
+	ASSERT(NotationParser::TranslateFromSAN(sanPosition, "O-O-O") == WhiteQueenSideCastle);
+	ASSERT(NotationParser::TranslateFromSAN(sanPosition, "O-O!?") == WhiteKingSideCastle);
+	ASSERT(NotationParser::TranslateFromSAN(sanPosition, "bxa8=N")->GetToType() == PieceType::Knight);
+	ASSERT(NotationParser::TranslateFromSAN(sanPosition, "b8Q#")->GetToType() == PieceType::Queen);
+	ASSERT(!NotationParser::TranslateFromSAN(sanPosition, "b8").has_value()); //missing promotion
+	ASSERT(!NotationParser::TranslateFromSAN(sanPosition, "Ra1").has_value()); //illegal
+	ASSERT(NotationParser::TranslateFromSAN(sanPosition, "Rxa8") == Move(PieceType::Rook, a1, a8));
+
+	//PGN with comments, variations, annotation glyphs and a FEN tag ; second game has an illegal move
+	const std::string pgn = "[Event \"Test\"]\n[Result \"1-0\"]\n\n1. e4 {best (by test)} e5 2. Nf3 (2. f4 exf4) Nc6 $1 3.Bb5 a6 1-0\n\n"
+		"[Event \"Illegal\"]\n[Result \"0-1\"]\n\n1. e5 e4 0-1\n\n"
+		"[FEN \"4k3/1P6/8/8/8/8/8/4K3 w - - 0 1\"]\n[Result \"*\"]\n\n1. b8=Q+ Kd7 *\n";
+	PgnReader pgnReader(1);
+	std::vector<PgnGame> games;
+	int moveCount = 0;
+	pgnReader.Parse(pgn, [&games](const PgnGame& game) { games.push_back(game); }, [&moveCount](const PgnGame& game, const Position& position, const Move& move) { moveCount++; });
+	ASSERT(games.size() == 2);
+	ASSERT(pgnReader.GetGameCount() == 2);
+	ASSERT(pgnReader.GetErrorCount() == 1);
+	ASSERT(games[0].m_Moves.size() == 6);
+	ASSERT(games[0].m_Result == 2 && games[0].m_HasResult);
+	ASSERT(games[0].m_Moves[4] == Move(PieceType::Bishop, f1, b5));
+	ASSERT(games[1].m_Moves.size() == 2);
+	ASSERT(games[1].m_Moves[0].GetToType() == PieceType::Queen);
+	ASSERT(!games[1].m_HasResult);
+	ASSERT(moveCount == 8);
 }
\ No newline at end of file
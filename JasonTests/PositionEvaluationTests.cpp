@@ -1,6 +1,11 @@
 #include "PositionEvaluationTests.h"
 #include "PositionEvaluation.h"
 #include "TestsUtility.h"
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <vector>
 
 void TestMovesToMate()
 {
@@ -27,9 +32,244 @@ void TestMovesToMate()
 	ASSERT(!movesToMate.has_value());
 }
 
+void TestTaperedEvaluation()
+{
+	ASSERT(PositionEvaluation::GetGamePhase(Position()) == MaxGamePhase);
+	ASSERT(PositionEvaluation::GetGamePhase(Position("4k3/pp3ppp/8/8/8/8/PP3PPP/4K3 w - - 0 1")) == 0);
+	ASSERT(PositionEvaluation::GetGamePhase(Position("3qk3/8/8/8/8/8/8/R3K3 w - - 0 1")) == 6);
+
+	//king should be centralized in endgame, kept safe in middlegame
+	Position centralKing("4k3/pp3ppp/8/8/4K3/8/PP3PPP/8 w - - 0 1");
+	Position cornerKing("4k3/pp3ppp/8/8/8/8/PP3PPP/7K w - - 0 1");
+	ASSERT(centralKing.GetEndgameScore() > cornerKing.GetEndgameScore());
+	ASSERT(centralKing.GetMiddlegameScore() < cornerKing.GetMiddlegameScore());
+
+	//piece-square tables are part of parameters
+	const std::vector<int> parameters = PositionEvaluation::GetParameters();
+	std::vector<int> modifiedParameters = parameters;
+	modifiedParameters.back() += 1;
+	PositionEvaluation::LoadParameters(modifiedParameters);
+	ASSERT(PositionEvaluation::GetParameters() == modifiedParameters);
+	PositionEvaluation::LoadParameters(parameters);
+	ASSERT(PositionEvaluation::GetParameters() == parameters);
+
+	//parameters of unexpected size are rejected, comma separated file as written by tuner is loaded
+	ASSERT(!PositionEvaluation::LoadParameters(std::vector<int>(parameters.begin(), parameters.end() - 1)));
+	ASSERT(PositionEvaluation::GetParameters() == parameters);
+	const std::string path = (std::filesystem::temp_directory_path() / "JasonTestsParameters.txt").string();
+	{
+		std::ofstream file(path);
+		for (size_t i = 0; i < modifiedParameters.size(); i++)
+			file << modifiedParameters[i] << ((i + 1 < modifiedParameters.size()) ? ", " : "\n");
+	}
+	ASSERT(PositionEvaluation::LoadParameters(path));
+	ASSERT(PositionEvaluation::GetParameters() == modifiedParameters);
+	std::ofstream(path) << "1, 2, x";
+	ASSERT(!PositionEvaluation::LoadParameters(path));
+	std::filesystem::remove(path);
+	PositionEvaluation::LoadParameters(parameters);
+}
+
+void TestEvaluationCache()
+{
+	Position position("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+	const int score = PositionEvaluation::EvaluatePosition(position, 0);
+	ASSERT(PositionEvaluation::EvaluatePosition(position, 0) == score);
+
+	//cached scores are discarded when parameters change
+	const std::vector<int> parameters = PositionEvaluation::GetParameters();
+	std::vector<int> modifiedParameters = parameters;
+	modifiedParameters[PositionEvaluation::TempoBonusIndex] += 10;
+	PositionEvaluation::LoadParameters(modifiedParameters);
+	ASSERT(PositionEvaluation::EvaluatePosition(position, 0) == score + 10);
+	PositionEvaluation::LoadParameters(parameters);
+	ASSERT(PositionEvaluation::EvaluatePosition(position, 0) == score);
+}
+
+/// <summary>Write network with random weights in NeuralNetwork::Load format</summary>
+static std::string GenerateRandomNetwork()
+{
+	std::default_random_engine generator;
+	std::uniform_int_distribution<int> distribution(-64, 64);
+	std::ostringstream stream;
+	stream.write("JNN1", 4);
+	const uint32_t hiddenSize = NeuralNetwork::HiddenSize;
+	stream.write(reinterpret_cast<const char*>(&hiddenSize), sizeof(hiddenSize));
+	const int weightCount = NeuralNetwork::InputSize * NeuralNetwork::HiddenSize + NeuralNetwork::HiddenSize + 2 * NeuralNetwork::HiddenSize + 1;
+	for (int i = 0; i < weightCount; i++)
+	{
+		const int16_t weight = static_cast<int16_t>(distribution(generator));
+		stream.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+	}
+
+	return stream.str();
+}
+
+void TestNeuralNetwork()
+{
+	std::istringstream invalidStream("JNN0");
+	ASSERT(!NeuralNetwork::Load(invalidStream));
+	ASSERT(!NeuralNetwork::IsLoaded());
+
+	std::istringstream stream(GenerateRandomNetwork());
+	ASSERT(NeuralNetwork::Load(stream));
+
+	//incremental accumulator should match accumulator computed from scratch
+	Position position("r3k2r/1P6/8/3p4/4P3/8/8/R3K2R w KQkq - 0 1");
+	std::vector<Move> moves = { Move(PieceType::Pawn, e4, d5), Move(PieceType::King, e8, g8), Move(PieceType::Pawn, PieceType::Queen, b7, a8),
+		Move(PieceType::Rook, f8, a8), Move(PieceType::King, e1, g1) };
+	for (Move& move : moves)
+	{
+		position.Update(move);
+		Position recomputed = position;
+		recomputed.ComputeAccumulator();
+		ASSERT(position.GetAccumulator().m_White == recomputed.GetAccumulator().m_White);
+		ASSERT(position.GetAccumulator().m_Black == recomputed.GetAccumulator().m_Black);
+	}
+
+	//evaluation is symmetric
+	Position mirrored("r4rk1/8/8/8/3P4/8/8/R4RK1 b - - 0 1");
+	position = Position("r4rk1/8/8/3p4/8/8/8/R4RK1 w - - 0 1");
+	ASSERT(NeuralNetwork::Evaluate(position) == -NeuralNetwork::Evaluate(mirrored));
+
+	NeuralNetwork::SetUse(true);
+	ASSERT(PositionEvaluation::EvaluatePosition(position, 0) == NeuralNetwork::Evaluate(position));
+	NeuralNetwork::SetUse(false);
+	NeuralNetwork::Unload();
+}
+
+void TestNeuralNetworkInstructionSets()
+{
+	std::istringstream stream(GenerateRandomNetwork());
+	ASSERT(NeuralNetwork::Load(stream));
+	const NeuralNetwork::InstructionSet instructionSet = NeuralNetwork::GetInstructionSet();
+
+	//vector kernels should give same accumulators and evaluations as scalar kernels
+	std::vector<Move> moves = { Move(PieceType::Pawn, e2, e4), Move(PieceType::Pawn, d7, d5), Move(PieceType::Pawn, e4, d5), Move(PieceType::Queen, d8, d5),
+		Move(PieceType::Knight, b1, c3), Move(PieceType::Queen, d5, a5) };
+	std::vector<std::pair<NeuralNetwork::Accumulator, int>> scalarResults;
+	for (NeuralNetwork::InstructionSet vectorInstructionSet : { NeuralNetwork::InstructionSet::Scalar, NeuralNetwork::InstructionSet::Sse2, NeuralNetwork::InstructionSet::Avx2 })
+	{
+		if (!NeuralNetwork::SetInstructionSet(vectorInstructionSet))
+		{
+			ASSERT(!NeuralNetwork::IsSupported(vectorInstructionSet));
+			continue;
+		}
+
+		Position position;
+		for (size_t i = 0; i < moves.size(); i++)
+		{
+			position.Update(moves[i]);
+			if (vectorInstructionSet == NeuralNetwork::InstructionSet::Scalar)
+			{
+				scalarResults.emplace_back(position.GetAccumulator(), NeuralNetwork::Evaluate(position));
+				continue;
+			}
+
+			ASSERT(position.GetAccumulator().m_White == scalarResults[i].first.m_White);
+			ASSERT(position.GetAccumulator().m_Black == scalarResults[i].first.m_Black);
+			ASSERT(NeuralNetwork::Evaluate(position) == scalarResults[i].second);
+		}
+	}
+
+	ASSERT(NeuralNetwork::SetInstructionSet(instructionSet));
+	NeuralNetwork::Unload();
+}
+
+/// <returns>Squares attacked by color, walking each direction of each piece square by square</returns>
+static uint64_t GetAttackedSquaresByWalking(const Position& position, bool isWhite)
+{
+	const uint64_t occupancy = position.GetWhitePieces() | position.GetBlackPieces();
+	const uint64_t ownPieces = isWhite ? position.GetWhitePieces() : position.GetBlackPieces();
+	const std::vector<std::pair<int, int>> knightSteps = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+	const std::vector<std::pair<int, int>> diagonalSteps = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+	const std::vector<std::pair<int, int>> straightSteps = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+	std::vector<std::pair<int, int>> allSteps = diagonalSteps;
+	allSteps.insert(allSteps.end(), straightSteps.begin(), straightSteps.end());
+
+	uint64_t attackedSquares = 0;
+	for (int square = 0; square < 64; square++)
+	{
+		const uint64_t squareBit = 1ULL << square;
+		const int file = square % 8;
+		const int rank = square / 8;
+		for (PieceType type : { PieceType::Pawn, PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen, PieceType::King })
+		{
+			const uint64_t pieces = position.GetPiecesOfType(type, isWhite);
+			if ((pieces & squareBit) == 0)
+				continue;
+
+			//pawns attack squares even if occupied by own pieces
+			const bool isPawn = (type == PieceType::Pawn);
+			const bool isSliding = (type == PieceType::Bishop) || (type == PieceType::Rook) || (type == PieceType::Queen);
+			std::vector<std::pair<int, int>> steps;
+			if (isPawn)
+				steps = { {-1, isWhite ? 1 : -1}, {1, isWhite ? 1 : -1} };
+			else if (type == PieceType::Knight)
+				steps = knightSteps;
+			else if (type == PieceType::Bishop)
+				steps = diagonalSteps;
+			else if (type == PieceType::Rook)
+				steps = straightSteps;
+			else
+				steps = allSteps;
+
+			for (const std::pair<int, int>& step : steps)
+			{
+				int targetFile = file + step.first;
+				int targetRank = rank + step.second;
+				while ((targetFile >= 0) && (targetFile < 8) && (targetRank >= 0) && (targetRank < 8))
+				{
+					const uint64_t targetBit = 1ULL << (targetRank * 8 + targetFile);
+					if (isPawn || ((targetBit & ownPieces) == 0))
+						attackedSquares |= targetBit;
+					if (!isSliding || ((targetBit & occupancy) != 0))
+						break;
+
+					targetFile += step.first;
+					targetRank += step.second;
+				}
+			}
+		}
+	}
+
+	return attackedSquares;
+}
+
 void PositionEvaluationTests::Run()
 {
 	TestMovesToMate();
+	TestTaperedEvaluation();
+	TestEvaluationCache();
+	TestNeuralNetwork();
+	TestNeuralNetworkInstructionSets();
+
+	//lazy evaluation returns material score when far outside of window
+	Position lazyPosition("4k3/8/8/8/8/8/PPP5/QQQ1K3 w - - 0 1");
+	ASSERT(PositionEvaluation::EvaluatePosition(lazyPosition, 0, -Mate, -1000) == PositionEvaluation::EvaluateMaterial<DefaultParameters>(lazyPosition));
+	ASSERT(PositionEvaluation::EvaluatePosition(lazyPosition, 0) != PositionEvaluation::EvaluateMaterial<DefaultParameters>(lazyPosition));
+
+	//material table: imbalance, phase and scale factors only depend on piece counts
+	const MaterialTableEntry& bishopPair = PositionEvaluation::GetMaterialEntry<DefaultParameters>(Position("1b2k3/8/8/8/8/8/8/2B1KB2 w - - 0 1"));
+	ASSERT(bishopPair.m_Score == PositionEvaluation::GetParameters()[PositionEvaluation::BishopPairBonusIndex]);
+	ASSERT(bishopPair.m_GamePhase == 3);
+	const MaterialTableEntry& rookAgainstBishop = PositionEvaluation::GetMaterialEntry<DefaultParameters>(Position("4k3/8/8/3b4/8/8/8/R3K3 w - - 0 1"));
+	ASSERT(rookAgainstBishop.m_WhiteScaleFactor < NormalScaleFactor);
+	ASSERT(rookAgainstBishop.m_BlackScaleFactor == 0);
+	const MaterialTableEntry& rookAndPawn = PositionEvaluation::GetMaterialEntry<DefaultParameters>(Position("4k3/8/8/3b4/8/8/P7/R3K3 w - - 0 1"));
+	ASSERT(rookAndPawn.m_WhiteScaleFactor == NormalScaleFactor);
+
+	//opposite colored bishops are drawish, bishop colors are checked after lookup
+	Position oppositeBishops("4k3/5p2/8/3b4/8/2B5/PP3P2/4K3 w - - 0 1");
+	Position sameBishops("4k3/5p2/8/4b3/8/2B5/PP3P2/4K3 w - - 0 1");
+	ASSERT(PositionEvaluation::GetMaterialEntry<DefaultParameters>(oppositeBishops).m_IsBishopsEnding);
+	ASSERT(PositionEvaluation::GetScaleFactor(oppositeBishops, PositionEvaluation::GetMaterialEntry<DefaultParameters>(oppositeBishops), true) < NormalScaleFactor);
+	ASSERT(PositionEvaluation::GetScaleFactor(sameBishops, PositionEvaluation::GetMaterialEntry<DefaultParameters>(sameBishops), true) == NormalScaleFactor);
+
+	ASSERT(Position("4k3/8/8/8/8/8/8/2N1K3 w - - 0 1").IsInsufficientMaterialFromBitboards());
+	ASSERT(!Position("4k1b1/8/8/8/8/8/8/2N1K3 w - - 0 1").IsInsufficientMaterialFromBitboards());
+	ASSERT(!Position("4k3/8/8/8/8/8/8/1NN1K3 w - - 0 1").IsInsufficientMaterialFromBitboards());
+	ASSERT(!Position("4k3/8/8/8/8/8/P7/2N1K3 w - - 0 1").IsInsufficientMaterialFromBitboards());
 
 	static Position position("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 	ASSERT(PositionEvaluation::CountDoubledPawns(position, true) == 0);
@@ -87,6 +327,37 @@ void PositionEvaluationTests::Run()
 	ASSERT(attackedSquaresAroundBlackKing.CountSetBits() == 5);
 	ASSERT(attackedSquaresAroundWhiteKing.CountSetBits() == 3);
 
+	//knight on e6 and queen on h5 attack squares around black king
+	PositionEvaluation::AttackInfo whiteAttacks = PositionEvaluation::GetAttackInfo<DefaultParameters>(position, true);
+	ASSERT(whiteAttacks.m_AttackedSquares == GetAttackedSquaresByWalking(position, true));
+	ASSERT(PositionEvaluation::GetAttackInfo<DefaultParameters>(position, false).m_AttackedSquares == GetAttackedSquaresByWalking(position, false));
+	ASSERT(whiteAttacks.m_KingAttackersCount == 2);
+	ASSERT(whiteAttacks.m_KingAttackersWeight == PositionEvaluation::GetParameters()[PositionEvaluation::KingAttackerWeightIndex] + PositionEvaluation::GetParameters()[PositionEvaluation::KingAttackerWeightIndex + 3]); //knight and queen
+
+	//pawn e2 attacks d3 and f3, king e1 attacks d1, d2, f1 and f2, rook h1 attacks g1, f1 and h2 to h8
+	position = Position("4k3/8/8/8/8/8/4P3/4K2R w K - 0 1");
+	const uint64_t kingAndRookAttacks = 0x8080808080808000ULL | 0x2000ULL | 0x800ULL | 0x68ULL;
+	ASSERT(PositionEvaluation::GetAttackedSquares(position, true) == (0x280000ULL | kingAndRookAttacks));
+	ASSERT(GetAttackedSquaresByWalking(position, true) == (0x280000ULL | kingAndRookAttacks));
+
+	//attacks of all pieces of starting position, and of sliding pieces blocked or not by pieces of both colors
+	Position startPosition;
+	ASSERT(PositionEvaluation::GetAttackedSquares(startPosition, true) == GetAttackedSquaresByWalking(startPosition, true));
+	ASSERT(PositionEvaluation::GetAttackedSquares(startPosition, false) == GetAttackedSquaresByWalking(startPosition, false));
+	for (const char* fen : { "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4", "8/2k5/3p4/p2P1p2/P2P1P2/8/8/4K2R b - - 0 1", "1r3rk1/p4ppp/2q5/3B4/8/2Q5/P4PPP/1R3RK1 w - - 0 1" })
+	{
+		position = Position(fen);
+		ASSERT(PositionEvaluation::GetAttackedSquares(position, true) == GetAttackedSquaresByWalking(position, true));
+		ASSERT(PositionEvaluation::GetAttackedSquares(position, false) == GetAttackedSquaresByWalking(position, false));
+	}
+
+	//only knights can move in starting position, to 2 squares each
+	whiteAttacks = PositionEvaluation::GetAttackInfo<DefaultParameters>(startPosition, true);
+	const PositionEvaluation::AttackInfo blackAttacks = PositionEvaluation::GetAttackInfo<DefaultParameters>(startPosition, false);
+	ASSERT(whiteAttacks.m_Mobility == 4 * PositionEvaluation::GetParameters()[PositionEvaluation::MobilityBonusIndex]);
+	ASSERT(blackAttacks.m_Mobility == whiteAttacks.m_Mobility);
+	ASSERT(whiteAttacks.m_KingAttackersCount == 0);
+
 	position = Position("rnb2rk1/pp1ppp2/4N1P1/8/5pQ1/2nN2b1/PP1PPP2/R3KBR1 w Qq - 0 1");
 	whiteAttackedSquares = PositionEvaluation::GetAttackedSquares(position, true);
 	attackedSquaresAroundBlackKing = PositionEvaluation::GetAttackedSquaresAroundKing(position, whiteAttackedSquares, false);
@@ -1,6 +1,11 @@
 #include "TestsUtility.h"
 #include "PositionTests.h"
 #include "Position.h"
+#include "PackedPosition.h"
+#include "OpeningIndex.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
 
 void PositionTests::Run()
 {
@@ -36,4 +41,177 @@ void PositionTests::Run()
 	ASSERT(position.GetZobristHash() == position.GetZobristHash());
 	ASSERT(position == startingPosition);
 	ASSERT(position.AreEqual(startingPosition));
+
+	TestPieceSquareScores();
+	TestPackedPosition();
+	TestOpeningIndex();
+}
+
+/// <summary>Incremental piece-square scores, pawn hash and material key should match values computed from scratch after captures, castling, promotion and undo</summary>
+void PositionTests::TestPieceSquareScores()
+{
+	Position position("r3k2r/1P6/8/3p4/4P3/8/8/R3K2R w KQkq - 0 1");
+	const int middlegameScore = position.GetMiddlegameScore();
+	const int endgameScore = position.GetEndgameScore();
+	Position recomputed = position;
+	recomputed.ComputePieceSquareScores();
+	ASSERT(recomputed.GetMiddlegameScore() == middlegameScore);
+	ASSERT(recomputed.GetEndgameScore() == endgameScore);
+
+	std::vector<Move> moves = { Move(PieceType::Pawn, e4, d5), Move(PieceType::King, e8, g8), Move(PieceType::Pawn, PieceType::Queen, b7, a8),
+		Move(PieceType::Rook, f8, a8), Move(PieceType::King, e1, g1) };
+	for (Move& move : moves)
+	{
+		position.Update(move);
+		recomputed = position;
+		recomputed.ComputePieceSquareScores();
+		ASSERT(position.GetMiddlegameScore() == recomputed.GetMiddlegameScore());
+		ASSERT(position.GetEndgameScore() == recomputed.GetEndgameScore());
+		ASSERT(position.GetPawnHash() == position.ComputePawnHash());
+		ASSERT(position.GetMaterialKey() == position.ComputeMaterialKey());
+	}
+
+	for (std::vector<Move>::const_reverse_iterator rit = moves.rbegin(); rit != moves.rend(); ++rit)
+		position.Undo(*rit);
+	ASSERT(position.GetMiddlegameScore() == middlegameScore);
+	ASSERT(position.GetEndgameScore() == endgameScore);
+	ASSERT(position.GetPawnHash() == position.ComputePawnHash());
+	ASSERT(position.GetMaterialKey() == position.ComputeMaterialKey());
+	ASSERT(position.GetPieceCount(PieceType::Rook, true) == 2);
+	ASSERT(position.GetPieceCount(PieceType::Pawn, false) == 1);
+	ASSERT(position.GetPieceCount(PieceType::Queen, true) == 0);
+
+	//pawn hash only depends on pawns
+	Position samePawns("r3k3/1P6/8/3p4/4P3/8/8/4K2R w K - 0 1");
+	ASSERT(samePawns.GetPawnHash() == position.GetPawnHash());
+	ASSERT(samePawns.GetZobristHash() != position.GetZobristHash());
+}
+
+/// <summary>Packed position round trip keeps pieces, castling rights, en passant square and best move, in memory and through a file</summary>
+void PositionTests::TestPackedPosition()
+{
+	Position unpacked;
+	for (const std::string& fen : { "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b Kq e3 0 3", "r3k3/1P6/8/3p4/4P3/8/8/4K2R w K - 0 1" })
+	{
+		const Position original(fen);
+		PackedPosition packedPosition = *PackedPosition::Pack(original);
+		packedPosition.SetMove(Move(PieceType::Pawn, PieceType::Queen, b7, b8));
+		ASSERT(packedPosition.Unpack(unpacked));
+		ASSERT(unpacked.GetZobristHash() == original.GetZobristHash());
+		ASSERT(unpacked.GetMaterialKey() == original.GetMaterialKey());
+		ASSERT(unpacked.GetMiddlegameScore() == original.GetMiddlegameScore());
+		ASSERT(unpacked.GetEnPassantSquare() == original.GetEnPassantSquare());
+		ASSERT(static_cast<int>(unpacked.GetWhitePiecesList().size()) == original.GetWhitePieces().CountSetBits());
+	}
+	const std::optional<Move> packedMove = PackedPosition::Pack(unpacked)->GetMove(unpacked);
+	ASSERT(!packedMove.has_value());
+	PackedPosition packedPosition = *PackedPosition::Pack(unpacked);
+	packedPosition.SetMove(Move(PieceType::Pawn, PieceType::Queen, b7, b8));
+	ASSERT(packedPosition.GetMove(unpacked) == Move(PieceType::Pawn, PieceType::Queen, b7, b8));
+	ASSERT(packedPosition.GetMove(unpacked)->GetToType() == PieceType::Queen);
+
+	//more than 32 pieces can't be packed, corrupted records are not unpacked
+	ASSERT(!PackedPosition::Pack(Position("QQQQQQQQ/QQQQQQQQ/QQQQQQQQ/QQQQQQQQ/QQQQQQQQ/8/4k3/4K3 w - - 0 1")).has_value());
+	PackedPosition corrupted = packedPosition;
+	corrupted.m_Pieces[0] |= 7;
+	ASSERT(!corrupted.IsValid());
+	ASSERT(!corrupted.Unpack(unpacked));
+	ASSERT(!corrupted.Unpack().has_value());
+	corrupted = packedPosition;
+	corrupted.m_Occupancy = ~0ULL;
+	ASSERT(!corrupted.Unpack(unpacked));
+
+	//positions written in two sessions, the second one appending, are read back in order
+	const std::vector<std::string> fens = { "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b Kq e3 0 3", "r3k3/1P6/8/3p4/4P3/8/8/4K2R w K - 0 1",
+		"4k3/8/8/8/8/8/8/QQ2K3 b - - 0 1" };
+	const std::string path = (std::filesystem::temp_directory_path() / "JasonTestsPackedPositions.bin").string();
+	for (size_t fenIdx = 0; fenIdx < fens.size(); fenIdx++)
+	{
+		PackedPositionWriter writer;
+		ASSERT(writer.Open(path, fenIdx != 0));
+		packedPosition = *PackedPosition::Pack(Position(fens[fenIdx]));
+		packedPosition.m_Score = static_cast<int16_t>(100 * static_cast<int>(fenIdx) - 50);
+		packedPosition.m_Result = static_cast<uint8_t>(fenIdx);
+		writer.Write(packedPosition);
+		ASSERT(writer.GetCount() == 1);
+	}
+
+	PackedPositionReader reader;
+	ASSERT(reader.Open(path));
+	ASSERT(reader.size() == fens.size());
+	for (size_t fenIdx = 0; fenIdx < fens.size(); fenIdx++)
+	{
+		const Position original(fens[fenIdx]);
+		ASSERT(reader[fenIdx].Unpack(unpacked));
+		ASSERT(unpacked.GetZobristHash() == original.GetZobristHash());
+		ASSERT(unpacked.GetEnPassantSquare() == original.GetEnPassantSquare());
+		ASSERT(reader[fenIdx].m_Score == 100 * static_cast<int>(fenIdx) - 50);
+		ASSERT(reader[fenIdx].m_Result == fenIdx);
+	}
+
+	reader.Close();
+	std::filesystem::remove(path);
+}
+
+/// <summary>Opening index lookups of a small index file, entries sorted by key then move</summary>
+void PositionTests::TestOpeningIndex()
+{
+	Position startPosition;
+	Position e4Position = startPosition;
+	Move e4Move(PieceType::Pawn, e2, e4);
+	e4Position.Update(e4Move);
+
+	std::vector<OpeningIndexEntry> entries(3);
+	entries[0].m_Key = startPosition.GetZobristHash();
+	entries[0].m_Move = PackedPosition::PackMove(Move(PieceType::Pawn, d2, d4));
+	entries[0].m_Draws = 2;
+	entries[1].m_Key = startPosition.GetZobristHash();
+	entries[1].m_Move = PackedPosition::PackMove(e4Move);
+	entries[1].m_WhiteWins = 3;
+	entries[1].m_RatingSum = 4000;
+	entries[1].m_RatedGameCount = 2;
+	entries[2].m_Key = e4Position.GetZobristHash();
+	entries[2].m_Move = PackedPosition::PackMove(Move(PieceType::Pawn, c7, c5));
+	entries[2].m_BlackWins = 1;
+	std::sort(entries.begin(), entries.end());
+
+	const std::string path = (std::filesystem::temp_directory_path() / "JasonTestsIndex.bin").string();
+	const auto writeIndex = [&path, &entries](const OpeningIndexHeader& header, size_t missingBytes)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(OpeningIndexEntry) - missingBytes);
+	};
+
+	//files of another version or other Zobrist keys, and partial entries are rejected
+	OpeningIndex openingIndex;
+	OpeningIndexHeader header = OpeningIndexHeader::Create();
+	header.m_Version++;
+	writeIndex(header, 0);
+	ASSERT(!openingIndex.Open(path));
+	header = OpeningIndexHeader::Create();
+	header.m_StartPositionKey ^= 1;
+	writeIndex(header, 0);
+	ASSERT(!openingIndex.Open(path));
+	writeIndex(OpeningIndexHeader::Create(), 1);
+	ASSERT(!openingIndex.Open(path));
+	ASSERT(openingIndex.size() == 0);
+
+	writeIndex(OpeningIndexHeader::Create(), 0);
+	ASSERT(openingIndex.Open(path));
+	ASSERT(openingIndex.size() == 3);
+	const std::vector<OpeningIndexEntry> startMoves = openingIndex.GetMoves(startPosition);
+	ASSERT(startMoves.size() == 2);
+	ASSERT(PackedPosition::UnpackMove(startPosition, startMoves[0].m_Move) == e4Move); //most played first
+	ASSERT(startMoves[0].GetGameCount() == 3 && startMoves[0].GetAverageRating() == 2000);
+	ASSERT(startMoves[1].GetAverageRating() == 0);
+	ASSERT(openingIndex.GetMoves(e4Position).size() == 1);
+	ASSERT(openingIndex.GetMoves(Position("4k3/8/8/8/8/8/8/4K3 w - - 0 1")).empty());
+
+	OpeningIndexEntry merged = startMoves[0];
+	merged.Merge(startMoves[1]);
+	ASSERT(merged.GetGameCount() == 5 && merged.GetAverageRating() == 2000);
+
+	openingIndex.Close();
+	std::filesystem::remove(path);
 }
\ No newline at end of file
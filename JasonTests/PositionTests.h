@@ -4,5 +4,10 @@ class PositionTests
 {
 public:
 	static void Run();
+
+private:
+	static void TestPieceSquareScores();
+	static void TestPackedPosition();
+	static void TestOpeningIndex();
 };
 
@@ -4,22 +4,70 @@
 #include "MoveSearcher.h"
 #include "TestsUtility.h"
 #include "NotationParser.h"
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
 
 static MoveMaker moveMaker;
-static void RunPosition(Position& position, int maxMoves, int evaluationDepth)
+/// <returns>Search duration, in seconds</returns>
+static double RunPosition(Position& position, int maxMoves, int evaluationDepth, uint64_t& nodeCount)
 {
 	int moveCount = 0;
 	bool moveFound = true;
 	int score = 0; //ignored
+	nodeCount = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 	while (moveFound && moveCount < maxMoves)
 	{
 		moveFound = moveMaker.MakeMove(position, evaluationDepth, score);
+		nodeCount += moveMaker.GetNodeCount();
 		moveCount++;
 	}
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void PrintSpeed(int testIdx, double duration, uint64_t nodeCount)
+{
+	std::cout << std::fixed << std::setprecision(3) << "SpeedTest" << testIdx << ": " << duration << " seconds, " << nodeCount << " nodes, "
+		<< static_cast<uint64_t>(nodeCount / std::max(duration, 0.001)) << " nps" << std::endl;
+}
+
+/// <summary>FEN parsing into a reused position, serialization into a reused buffer, and construction of positions from FEN strings</summary>
+static void RunFENBenchmark()
+{
+	static constexpr int Iterations = 20000;
+	const std::array<std::string, 4> fens = { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"r1b3k1/p1b1Bppp/5n2/2n1p1N1/2B5/3P4/2Q2PPP/qN2R1K1 b - - 5 19", "5k2/2n5/8/1pP5/2pP4/8/5B2/1K6 w - - 0 1" };
+
+	Position position;
+	std::array<char, NotationParser::MaxFENLength> buffer;
+	size_t length = 0; //so that serialization isn't optimized away
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Iterations; i++)
+		NotationParser::ParseFEN(fens[i % fens.size()], position);
+	const double parseDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Iterations; i++)
+		length += NotationParser::ToFEN(position, buffer).size();
+	const double serializeDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Iterations; i++)
+		length += Position(fens[i % fens.size()]).GetMoves().size();
+	const double constructDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << std::fixed << std::setprecision(3) << "FEN parsing: " << 1e9 * parseDuration / Iterations << " ns, serialization: " << 1e9 * serializeDuration / Iterations
+		<< " ns, position construction: " << 1e9 * constructDuration / Iterations << " ns (" << length << " characters)" << std::endl;
+	ASSERT(NotationParser::ToFEN(position, buffer) == fens[(Iterations - 1) % fens.size()]);
 }
 
 void SpeedTest::Run()
 {
+	RunFENBenchmark();
+
 	Position position1("r1bqk1nr/ppp2ppp/2n1p3/3p4/1bPP4/2N2N2/PP2PPPP/R1BQKB1R w KQkq - 0 1");
 	Position position2("r1bqk2r/2p1ppbp/p1np1np1/1p6/3PPP2/2NBBN2/PPP3PP/R2QK2R w KQkq - 0 1");
 	Position position3("r3r1k1/3q2bp/p1Np2p1/P2Pp1Pn/1R3p1P/KP3P2/6Q1/3RB3 w - - 0 1");
@@ -29,54 +77,38 @@ void SpeedTest::Run()
 	Position position7("6k1/5p2/6p1/8/7p/8/6PP/6K1 b - - 0 0");
 	Position position8("5k2/2n5/8/1pP5/2pP4/8/5B2/1K6 w - -");
 
-	time_t start;
-	time_t end;
-
-	time(&start);
-	RunPosition(position1, 1, 7);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest1: %.2lf seconds.");
-	//ASSERT(difftime(end, start) < 10.0);
-
-	time(&start);
-	RunPosition(position2, 1, 6);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest2: %.2lf seconds.");
-	//ASSERT(difftime(end, start) < 3.0);
-
-	time(&start);
-	RunPosition(position3, 1, 6);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest3: %.2lf seconds.");
-	ASSERT(difftime(end, start) < 15.0);
-
-	time(&start);
-	RunPosition(position4, 1, 7);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest4: %.2lf seconds.");
-	ASSERT(difftime(end, start) < 5.0);
-
-	time(&start);
-	RunPosition(position5, 1, 7);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest5: %.2lf seconds.");
-	ASSERT(difftime(end, start) < 10.0);
-
-	time(&start);
-	RunPosition(position6, 1, 8);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest6: %.2lf seconds.");
-	ASSERT(difftime(end, start) < 3.0);
-
-	time(&start);
-	RunPosition(position7, 1, 14);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest7: %.2lf seconds.");
-	ASSERT(difftime(end, start) < 5.0);
-
-	time(&start);
-	RunPosition(position8, 1, 10);
-	time(&end);
-	PrintTestDuration(start, end, "SpeedTest8: %.2lf seconds.");
-	ASSERT(difftime(end, start) < 3.0);
+	uint64_t nodeCount = 0;
+	double duration = 0.0;
+
+	duration = RunPosition(position1, 1, 7, nodeCount);
+	PrintSpeed(1, duration, nodeCount);
+	//ASSERT(duration < 10.0);
+
+	duration = RunPosition(position2, 1, 6, nodeCount);
+	PrintSpeed(2, duration, nodeCount);
+	//ASSERT(duration < 3.0);
+
+	duration = RunPosition(position3, 1, 6, nodeCount);
+	PrintSpeed(3, duration, nodeCount);
+	ASSERT(duration < 15.0);
+
+	duration = RunPosition(position4, 1, 7, nodeCount);
+	PrintSpeed(4, duration, nodeCount);
+	ASSERT(duration < 5.0);
+
+	duration = RunPosition(position5, 1, 7, nodeCount);
+	PrintSpeed(5, duration, nodeCount);
+	ASSERT(duration < 10.0);
+
+	duration = RunPosition(position6, 1, 8, nodeCount);
+	PrintSpeed(6, duration, nodeCount);
+	ASSERT(duration < 3.0);
+
+	duration = RunPosition(position7, 1, 14, nodeCount);
+	PrintSpeed(7, duration, nodeCount);
+	ASSERT(duration < 5.0);
+
+	duration = RunPosition(position8, 1, 10, nodeCount);
+	PrintSpeed(8, duration, nodeCount);
+	ASSERT(duration < 3.0);
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "TunerTests.h"
+#include "TestsUtility.h"
+#include "JasonTuner/Tuner.h"
+#include "JasonTuner/Spsa.h"
+#include "JasonTuner/DataGenerator.h"
+#include "MoveSearcher.h"
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+void TunerTests::Run()
+{
+	TestParse();
+	TestQuietPositions();
+	TestSpsa();
+	TestDataGenerator();
+}
+
+/// <summary>SPSA with a fixed game pair score instead of self-play games, recording perturbed parameters</summary>
+class StubSpsa : public Spsa
+{
+public:
+	StubSpsa(double score, uint32_t seed) : Spsa(1, 0.0, 0.0, seed), m_Score(score) {};
+
+	std::vector<std::pair<SearchParameters, SearchParameters>> m_GamePairs; //plus and minus parameters of each game pair
+
+protected:
+	double PlayGamePair(const SearchParameters& plusParameters, const SearchParameters& minusParameters, std::mt19937& generator) override
+	{
+		m_GamePairs.emplace_back(plusParameters, minusParameters);
+		return m_Score;
+	}
+
+private:
+	double m_Score = 1.0;
+};
+
+void TunerTests::TestParse()
+{
+	//results of all accepted formats, with and without move clocks
+	const std::string fen = "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3";
+	const std::vector<std::pair<std::string, uint8_t>> results = { { "1-0", 2 }, { "0-1", 0 }, { "1/2-1/2", 1 }, { "[1.0]", 2 }, { "[0.5]", 1 }, { "[0.0]", 0 } };
+	for (const std::pair<std::string, uint8_t>& result : results)
+	{
+		for (const std::string& line : { fen + " " + result.first, "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - " + result.first })
+		{
+			const std::optional<PackedPosition> packedPosition = Tuner::Parse(line);
+			ASSERT(packedPosition.has_value());
+			ASSERT(packedPosition->m_Result == result.second);
+
+			const std::optional<Position> position = packedPosition->Unpack();
+			ASSERT(position.has_value());
+			ASSERT(position->GetZobristHash() == Position(fen).GetZobristHash());
+		}
+	}
+
+	//malformed lines
+	ASSERT(!Tuner::Parse("").has_value());
+	ASSERT(!Tuner::Parse(fen).has_value()); //no result
+	ASSERT(!Tuner::Parse(fen + " 2-0").has_value());
+	ASSERT(!Tuner::Parse("r1bqkbnr/pppp1ppp 1-0").has_value()); //truncated FEN
+	ASSERT(!Tuner::Parse("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1X w KQkq - 2 3 1-0").has_value()); //unknown piece
+}
+
+void TunerTests::TestQuietPositions()
+{
+	//positions in check and positions where quiescent search differs from static evaluation are dropped
+	const std::vector<std::string> lines = {
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 1/2-1/2", //quiet
+		"4k3/8/8/8/8/8/8/4K2r w - - 0 1 0-1", //white king in check
+		"4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1 1-0", //hanging queen, capture changes score
+		"not a position 1-0", //malformed
+		"4k3/pppp4/8/8/8/8/PPPP4/4K3 b - - 0 1 [0.5]" }; //quiet
+	for (int threadCount : { 1, 2 })
+	{
+		Tuner tuner(threadCount);
+		tuner.AddQuietPositions(lines.size(), [&lines](size_t i) { return Tuner::Parse(lines[i]); });
+		ASSERT(tuner.GetPositionCount() == 2);
+
+		std::vector<uint64_t> hashes;
+		for (const PackedPosition& packedPosition : tuner.m_Positions)
+			hashes.push_back(packedPosition.Unpack()->GetZobristHash());
+		ASSERT(std::find(hashes.begin(), hashes.end(), Position().GetZobristHash()) != hashes.end());
+		ASSERT(std::find(hashes.begin(), hashes.end(), Position("4k3/pppp4/8/8/8/8/PPPP4/4K3 b - - 0 1").GetZobristHash()) != hashes.end());
+	}
+
+	//error is computed from kept positions only
+	Tuner tuner(2);
+	tuner.AddQuietPositions(lines.size(), [&lines](size_t i) { return Tuner::Parse(lines[i]); });
+	const double error = tuner.ComputeError(1.0);
+	ASSERT(error > 0.0 && error < 0.25);
+}
+
+void TunerTests::TestSpsa()
+{
+	const SearchParameters defaultParameters;
+	for (double score : { 2.0, 0.0 })
+	{
+		//one iteration: parameters move toward plus parameters when they win both games, toward minus parameters when they lose both
+		StubSpsa spsa(score, 42);
+		const SearchParameters parameters = spsa.Run(1, "");
+		ASSERT(spsa.m_GamePairs.size() == 1);
+		for (const SearchParameterDescription& description : SearchParameterDescriptions)
+		{
+			const int plusValue = spsa.m_GamePairs[0].first.*description.m_Value;
+			const int minusValue = spsa.m_GamePairs[0].second.*description.m_Value;
+			const int value = parameters.*description.m_Value;
+			const int defaultValue = defaultParameters.*description.m_Value;
+			ASSERT(plusValue != minusValue);
+			const bool isIncreased = ((plusValue > minusValue) == (score > 1.0));
+			ASSERT(isIncreased ? (value > defaultValue || value == description.m_Max) : (value < defaultValue || value == description.m_Min));
+		}
+	}
+
+	//perturbations decay but rounded plus and minus parameters always differ, all parameters stay within bounds
+	for (double score : { 2.0, 0.0, 1.0 })
+	{
+		StubSpsa spsa(score, 42);
+		const SearchParameters parameters = spsa.Run(2000, "");
+		ASSERT(spsa.m_GamePairs.size() == 2000);
+		for (const std::pair<SearchParameters, SearchParameters>& gamePair : spsa.m_GamePairs)
+		{
+			for (const SearchParameterDescription& description : SearchParameterDescriptions)
+			{
+				ASSERT(gamePair.first.*description.m_Value != gamePair.second.*description.m_Value);
+				for (const SearchParameters& gamePairParameters : { gamePair.first, gamePair.second, parameters })
+				{
+					ASSERT(gamePairParameters.*description.m_Value >= description.m_Min);
+					ASSERT(gamePairParameters.*description.m_Value <= description.m_Max);
+				}
+			}
+		}
+	}
+
+	//same seed, same perturbations
+	StubSpsa spsa1(1.0, 7);
+	StubSpsa spsa2(1.0, 7);
+	spsa1.Run(10, "");
+	spsa2.Run(10, "");
+	for (size_t i = 0; i < spsa1.m_GamePairs.size(); i++)
+	{
+		for (const SearchParameterDescription& description : SearchParameterDescriptions)
+			ASSERT(spsa1.m_GamePairs[i].first.*description.m_Value == spsa2.m_GamePairs[i].first.*description.m_Value);
+	}
+}
+
+void TunerTests::TestDataGenerator()
+{
+	//games at fixed depth from seeded random openings
+	DataGenerator dataGenerator(1, 0, 2);
+	std::unique_ptr<MoveMaker> moveMaker = std::make_unique<MoveMaker>();
+	std::mt19937 generator(42);
+	for (int game = 0; game < 2; game++)
+	{
+		std::vector<PackedPosition> packedPositions;
+		const uint8_t result = dataGenerator.PlayGame(*moveMaker, generator, packedPositions);
+		ASSERT(result <= 2);
+		ASSERT(!packedPositions.empty());
+
+		std::optional<int> lastScores[2]; //last score of positions with black and white to play
+		for (const PackedPosition& packedPosition : packedPositions)
+		{
+			ASSERT(packedPosition.m_Result == result);
+			ASSERT(abs(packedPosition.m_Score) < Mate - MaxPly);
+
+			//stored positions are not in check, their best move is a legal quiet move
+			std::optional<Position> position = packedPosition.Unpack();
+			ASSERT(position.has_value());
+			ASSERT(!MoveSearcher::IsKingInCheckFromBitboards(*position, position->IsWhiteToPlay()));
+			const std::optional<Move> bestMove = packedPosition.GetMove(*position);
+			ASSERT(bestMove.has_value());
+			MoveList<MaxMoves> moves;
+			MoveSearcher::GetLegalMovesFromBitboards(*position, moves);
+			const auto legalMove = std::find(moves.begin(), moves.end(), *bestMove);
+			ASSERT(legalMove != moves.end());
+			ASSERT(!legalMove->IsCapture());
+			ASSERT(legalMove->GetFromType() == legalMove->GetToType());
+
+			lastScores[position->IsWhiteToPlay() ? 1 : 0] = packedPosition.m_Score;
+		}
+
+		//scores are from white point of view whichever side plays, decisive games end with scores favoring the winner
+		if (result != 1)
+		{
+			for (const std::optional<int>& lastScore : lastScores)
+				ASSERT(lastScore.has_value() && ((result == 2) ? (*lastScore > 0) : (*lastScore < 0)));
+		}
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+class TunerTests
+{
+public:
+	static void Run();
+
+private:
+	static void TestParse();
+	static void TestQuietPositions();
+	static void TestSpsa();
+	static void TestDataGenerator();
+};
@@ -2,6 +2,93 @@
 #include "TestsUtility.h"
 #include "Position.h"
 #include "MoveSearcher.h"
+#include "PolyglotBook.h"
+#include "MoveMaker.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <memory>
+
+/// <summary>Access to book moves decoding</summary>
+class PolyglotBookTester : public PolyglotBook
+{
+public:
+	using PolyglotBook::DecodeMove;
+};
+
+static void WriteBigEndian(std::ofstream& file, uint64_t value, int size)
+{
+	for (int i = size - 1; i >= 0; i--)
+		file.put(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+static void TestPolyglotBook()
+{
+	//keys of Polyglot book format specification
+	ASSERT(PolyglotBook::GetKey(Position()) == 0x463B96181691FC9C);
+	Position position;
+	Move e4Move(PieceType::Pawn, e2, e4);
+	position.Update(e4Move);
+	ASSERT(PolyglotBook::GetKey(position) == 0x823C9B50FD114196);
+	ASSERT(PolyglotBook::GetKey(Position("rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2")) == 0x0756B94461C50FB0);
+	ASSERT(PolyglotBook::GetKey(Position("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3")) == 0x22A48B5A8E47FF78);
+	ASSERT(PolyglotBook::GetKey(Position("rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4")) == 0x00FDD303C946BDD9);
+	ASSERT(PolyglotBook::GetKey(Position("rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4")) == 0x5C3F9B829B279560);
+
+	//en passant key only if en passant capture is possible
+	ASSERT(PolyglotBook::GetKey(position) == PolyglotBook::GetKey(Position("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1")));
+	ASSERT(PolyglotBook::GetKey(Position("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1")) != PolyglotBook::GetKey(Position("4k3/8/8/3pP3/8/8/8/4K3 w - - 0 1")));
+
+	//castling is encoded as king takes rook
+	Position castlePosition("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+	ASSERT(PolyglotBookTester::DecodeMove(castlePosition, static_cast<uint16_t>(h1 | (e1 << 6))) == WhiteKingSideCastle);
+	ASSERT(PolyglotBookTester::DecodeMove(castlePosition, static_cast<uint16_t>(a1 | (e1 << 6))) == WhiteQueenSideCastle);
+	ASSERT(!PolyglotBookTester::DecodeMove(castlePosition, static_cast<uint16_t>(e4 | (e1 << 6))).has_value());
+
+	//book with start position moves, an illegal move and a move of another position, sorted by key
+	struct Entry { uint64_t m_Key; Square m_From; Square m_To; int m_Weight; };
+	std::vector<Entry> entries = { { PolyglotBook::GetKey(Position()), e2, e4, 3 }, { PolyglotBook::GetKey(Position()), d2, d4, 1 },
+		{ PolyglotBook::GetKey(Position()), e2, e5, 10 }, { PolyglotBook::GetKey(Position()), g1, f3, 0 }, { PolyglotBook::GetKey(position), e7, e5, 1 } };
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& entry1, const Entry& entry2) { return entry1.m_Key < entry2.m_Key; });
+	const std::string path = (std::filesystem::temp_directory_path() / "JasonTestsBook.bin").string();
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		for (const Entry& entry : entries)
+		{
+			WriteBigEndian(file, entry.m_Key, 8);
+			WriteBigEndian(file, entry.m_To | (entry.m_From << 6), 2);
+			WriteBigEndian(file, entry.m_Weight, 2);
+			WriteBigEndian(file, 0, 4);
+		}
+	}
+
+	PolyglotBook book;
+	ASSERT(book.Open(path));
+	std::mt19937 bookGenerator(0);
+	Position startPosition;
+	int e4Count = 0;
+	for (int i = 0; i < 100; i++)
+	{
+		const std::optional<Move> move = book.GetMove(startPosition, bookGenerator);
+		ASSERT(move == Move(PieceType::Pawn, e2, e4) || move == Move(PieceType::Pawn, d2, d4));
+		e4Count += (move == Move(PieceType::Pawn, e2, e4)) ? 1 : 0;
+	}
+	ASSERT(e4Count > 50 && e4Count < 100);
+	ASSERT(book.GetMove(position, bookGenerator) == Move(PieceType::Pawn, e7, e5));
+	ASSERT(!book.GetMove(castlePosition, bookGenerator).has_value());
+
+	//searching plays book move
+	std::unique_ptr<MoveMaker> moveMaker = std::make_unique<MoveMaker>();
+	moveMaker->SetBook(&book);
+	int score = 0;
+	Position searchPosition;
+	ASSERT(moveMaker->MakeMove(searchPosition, 8, score));
+	ASSERT(moveMaker->GetNodeCount() == 0);
+	ASSERT(searchPosition.GetMoves().back() == Move(PieceType::Pawn, e2, e4) || searchPosition.GetMoves().back() == Move(PieceType::Pawn, d2, d4));
+
+	book.Close();
+	std::filesystem::remove(path);
+}
 
 void ZobristTests::Run()
 {
@@ -244,4 +331,6 @@ void ZobristTests::Run()
 	newPosition.Undo(move2);
 	newPosition.Undo(move1);
 	ASSERT(newPosition.GetZobristHash() == startingPosition.GetZobristHash());
+
+	TestPolyglotBook();
 }
\ No newline at end of file
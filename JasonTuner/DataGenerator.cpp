@@ -0,0 +1,114 @@
+#include "DataGenerator.h"
+#include "SelfPlay.h"
+#include "MoveSearcher.h"
+#include <iostream>
+#include <thread>
+#include <memory>
+#include <chrono>
+
+bool DataGenerator::Run(int gameCount, const std::string& outputPath)
+{
+	PackedPositionWriter writer;
+	if (!writer.Open(outputPath, true))
+		return false;
+
+	m_NextGame = 0;
+	m_FinishedThreadCount = 0;
+	m_GameCount = 0;
+
+	std::thread writerThread(&DataGenerator::WritePositions, this, std::ref(writer));
+	std::vector<std::thread> threads;
+	for (int threadIdx = 0; threadIdx < m_ThreadCount; threadIdx++)
+		threads.emplace_back(&DataGenerator::RunThread, this, threadIdx, gameCount);
+
+	for (std::thread& thread : threads)
+		thread.join();
+	writerThread.join();
+
+	return true;
+}
+
+void DataGenerator::RunThread(int threadIdx, int gameCount)
+{
+	std::random_device randomDevice;
+	std::mt19937 generator(randomDevice() + threadIdx);
+	std::unique_ptr<MoveMaker> moveMaker = std::make_unique<MoveMaker>(); //each thread has its own transposition table
+	moveMaker->SetNodeLimit(m_Depth == 0 ? m_Nodes : 0);
+	while (m_NextGame++ < gameCount)
+	{
+		std::vector<PackedPosition> packedPositions;
+		PlayGame(*moveMaker, generator, packedPositions);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Queue.push_back(std::move(packedPositions));
+		m_Condition.notify_one();
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_FinishedThreadCount++;
+	m_Condition.notify_one();
+}
+
+uint8_t DataGenerator::PlayGame(MoveMaker& moveMaker, std::mt19937& generator, std::vector<PackedPosition>& packedPositions) const
+{
+	Position position;
+	for (Move move : SelfPlay::GetRandomOpening(generator, GameLoop::OpeningPlies))
+		position.Update(move);
+
+	const double result = GameLoop::Play(position, Adjudication, moveMaker, [&](Position& gamePosition, int ply, int& whiteScore)
+	{
+		const bool isInCheck = MoveSearcher::IsKingInCheckFromBitboards(gamePosition, gamePosition.IsWhiteToPlay());
+		PackedPosition packedPosition = *PackedPosition::Pack(gamePosition); //games start from the initial position
+
+		if (!moveMaker.MakeMove(gamePosition, m_Depth == 0 ? MaxPvLength : m_Depth, whiteScore))
+			return false;
+
+		//score is from white point of view
+		const Move& move = gamePosition.GetMoves().back();
+		const bool isQuiet = !isInCheck && !move.IsCapture() && (move.GetFromType() == move.GetToType());
+		if (isQuiet && (abs(whiteScore) < Mate - MaxPly))
+		{
+			packedPosition.m_Score = static_cast<int16_t>(whiteScore);
+			packedPosition.SetMove(move);
+			packedPositions.push_back(packedPosition);
+		}
+
+		return true;
+	});
+
+	const uint8_t packedResult = static_cast<uint8_t>(2.0 * result);
+	for (PackedPosition& packedPosition : packedPositions)
+		packedPosition.m_Result = packedResult;
+
+	return packedResult;
+}
+
+void DataGenerator::WritePositions(PackedPositionWriter& writer)
+{
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<std::vector<PackedPosition>> queue;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return !m_Queue.empty() || m_FinishedThreadCount == m_ThreadCount; });
+			if (m_Queue.empty())
+				break;
+
+			queue.swap(m_Queue);
+		}
+
+		//file is written outside of lock, so that worker threads aren't blocked by disk
+		for (const std::vector<PackedPosition>& packedPositions : queue)
+		{
+			for (const PackedPosition& packedPosition : packedPositions)
+				writer.Write(packedPosition);
+			m_GameCount++;
+		}
+		queue.clear();
+		writer.Flush();
+
+		const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Games: " << m_GameCount << ", positions: " << writer.GetCount() << ", positions/s: " << static_cast<int>(writer.GetCount() / duration) << std::endl;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stdint.h>
+#include "MoveMaker.h"
+#include "PackedPosition.h"
+#include "GameLoop.h"
+
+/// <summary>
+/// Self-play games from random openings at fixed nodes or depth, quiet positions are recorded with their search score, best move and game result
+/// </summary>
+/// <remark>Games are played on worker threads, positions of finished games are written as packed positions by a background writer thread</remark>
+class DataGenerator
+{
+public:
+	/// <param name="nodes">nodes per move, if depth is 0</param>
+	/// <param name="depth">fixed search depth per move if not 0</param>
+	DataGenerator(int threadCount, uint64_t nodes, int depth) : m_ThreadCount(threadCount), m_Nodes(nodes), m_Depth(depth) {};
+
+	/// <summary>Play games and append positions to output file</summary>
+	/// <returns>False if output file can't be opened</returns>
+	bool Run(int gameCount, const std::string& outputPath);
+
+private:
+	static constexpr AdjudicationSettings Adjudication = { 1000, 4, 10, 12, 60 }; //win score and plies, draw score, plies and min ply
+
+	/// <summary>Play games on one thread until game count is reached</summary>
+	void RunThread(int threadIdx, int gameCount);
+
+	/// <summary>Play a game, quiet positions are added to packed positions with game result</summary>
+	/// <remark>Positions in check, positions where best move is a capture or a promotion, and mate scores are skipped</remark>
+	/// <returns>Game result: 0 if black won, 1 if draw, 2 if white won</returns>
+	uint8_t PlayGame(MoveMaker& moveMaker, std::mt19937& generator, std::vector<PackedPosition>& packedPositions) const;
+
+	/// <summary>Write queued positions until all games are played, on background thread</summary>
+	void WritePositions(PackedPositionWriter& writer);
+
+	int m_ThreadCount = 1;
+	uint64_t m_Nodes = 0;
+	int m_Depth = 0;
+	std::atomic<int> m_NextGame = 0;
+
+	std::mutex m_Mutex; //protects members below
+	std::condition_variable m_Condition; //notified when positions are queued or when all games are played
+	std::vector<std::vector<PackedPosition>> m_Queue; //positions of finished games, waiting to be written
+	int m_FinishedThreadCount = 0;
+
+	int m_GameCount = 0; //written games, only used by writer thread
+
+	friend class TunerTests;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include "Tuner.h"
+#include "Spsa.h"
+#include "DataGenerator.h"
+#include "OpeningIndexBuilder.h"
+#include "BatchAnalyzer.h"
+#include "NotationParser.h"
+#include <fstream>
+
+static void PrintUsage()
+{
+	std::cout << "Usage: JasonTuner <positions file> [-threads N] [-iterations N] [-pst] [-output file]" << std::endl;
+	std::cout << "       JasonTuner -spsa [-threads N] [-iterations N] [-time seconds] [-increment seconds] [-output file]" << std::endl;
+	std::cout << "       JasonTuner -datagen [-threads N] [-games N] [-nodes N | -depth N] [-output file]" << std::endl;
+	std::cout << "       JasonTuner -index <PGN files> [-threads N] [-plies N] [-mingames N] [-output file]" << std::endl;
+	std::cout << "       JasonTuner -analyze <FEN file> [-threads N] [-nodes N | -depth N] [-time seconds] [-sharedtt]" << std::endl;
+	std::cout << "Positions file has one position per line: FEN followed by game result, e.g. 1-0, 0-1, 1/2-1/2 or [1.0], [0.5], [0.0]" << std::endl;
+	std::cout << "or is a .bin file of packed positions, e.g. written by -datagen" << std::endl;
+	std::cout << "Tuned evaluation parameters are written comma separated to output file, which is loaded by the UCI ParametersFile option" << std::endl;
+	std::cout << "SPSA tunes search parameters with self-play game pairs, time is per game for each side" << std::endl;
+	std::cout << "Data generation plays self-play games from random openings, quiet positions are appended with search score and game result" << std::endl;
+	std::cout << "Index aggregates moves of PGN games with a result into an opening index file, e.g. for the UCI explore command" << std::endl;
+	std::cout << "Analyze searches each FEN line of file in parallel and prints results as they finish, time is per position, 5000 nodes if no limit is given" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::string positionsPath = argv[1];
+	const bool isSpsa = (positionsPath == "-spsa");
+	const bool isDataGeneration = (positionsPath == "-datagen");
+	const bool isIndex = (positionsPath == "-index");
+	const bool isAnalysis = (positionsPath == "-analyze");
+	int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	int maxIterations = isSpsa ? 10000 : 1000;
+	bool tunePieceSquareTables = false;
+	double time = 4.0;
+	double increment = 0.4;
+	int gameCount = 10000;
+	uint64_t nodes = 5000;
+	int depth = 0;
+	int indexPlies = 40;
+	uint32_t minGameCount = 1;
+	std::vector<std::string> pgnPaths;
+	std::string fenPath;
+	bool hasTime = false;
+	bool hasNodes = false;
+	bool shareTranspositionTable = false;
+	std::string outputPath = isSpsa ? "searchParameters.txt" : (isDataGeneration ? "data.bin" : (isIndex ? "index.bin" : "parameters.txt"));
+	for (int i = 2; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		if (argument == "-threads" && i + 1 < argc)
+			threadCount = std::max(1, std::stoi(argv[++i]));
+		else if (argument == "-iterations" && i + 1 < argc)
+			maxIterations = std::stoi(argv[++i]);
+		else if (argument == "-pst")
+			tunePieceSquareTables = true;
+		else if (argument == "-time" && i + 1 < argc)
+		{
+			time = std::stod(argv[++i]);
+			hasTime = true;
+		}
+		else if (argument == "-increment" && i + 1 < argc)
+			increment = std::stod(argv[++i]);
+		else if (argument == "-games" && i + 1 < argc)
+			gameCount = std::stoi(argv[++i]);
+		else if (argument == "-nodes" && i + 1 < argc)
+		{
+			nodes = std::stoull(argv[++i]);
+			hasNodes = true;
+		}
+		else if (argument == "-depth" && i + 1 < argc)
+			depth = std::stoi(argv[++i]);
+		else if (argument == "-output" && i + 1 < argc)
+			outputPath = argv[++i];
+		else if (argument == "-plies" && i + 1 < argc)
+			indexPlies = std::clamp(std::stoi(argv[++i]), 1, MaxPly - 1);
+		else if (argument == "-mingames" && i + 1 < argc)
+			minGameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (isIndex && argument[0] != '-')
+			pgnPaths.push_back(argument);
+		else if (argument == "-sharedtt")
+			shareTranspositionTable = true;
+		else if (isAnalysis && argument[0] != '-' && fenPath.empty())
+			fenPath = argument;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (isSpsa)
+	{
+		std::cout << "SPSA with " << threadCount << " threads, " << time << "s + " << increment << "s games" << std::endl;
+		Spsa spsa(threadCount, time, increment);
+		spsa.Run(maxIterations, outputPath);
+		std::cout << "Search parameters written to " << outputPath << std::endl;
+		return 0;
+	}
+
+	if (isDataGeneration)
+	{
+		std::cout << "Data generation with " << threadCount << " threads, " << (depth == 0 ? std::to_string(nodes) + " nodes" : "depth " + std::to_string(depth)) << " per move" << std::endl;
+		DataGenerator dataGenerator(threadCount, nodes, depth);
+		if (!dataGenerator.Run(gameCount, outputPath))
+		{
+			std::cout << "Can't write " << outputPath << std::endl;
+			return 1;
+		}
+		std::cout << "Packed positions appended to " << outputPath << std::endl;
+		return 0;
+	}
+
+	if (isIndex)
+	{
+		std::cout << "Indexing " << pgnPaths.size() << " PGN files with " << threadCount << " threads, " << indexPlies << " plies per game" << std::endl;
+		OpeningIndexBuilder builder(threadCount, indexPlies, minGameCount);
+		if (!builder.Build(pgnPaths, outputPath))
+		{
+			std::cout << "Can't write " << outputPath << std::endl;
+			return 1;
+		}
+		std::cout << builder.GetEntryCount() << " moves of " << builder.GetGameCount() << " games written to " << outputPath << std::endl;
+		return 0;
+	}
+
+	if (isAnalysis)
+	{
+		std::ifstream file(fenPath);
+		if (!file.is_open())
+		{
+			std::cout << "Can't read " << fenPath << std::endl;
+			return 1;
+		}
+
+		std::vector<AnalysisRequest> requests;
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.empty())
+				continue;
+
+			AnalysisRequest& request = requests.emplace_back();
+			request.m_Fen = line;
+			request.m_Depth = depth;
+			request.m_Nodes = (hasNodes || ((depth == 0) && !hasTime)) ? nodes : 0; //default node count only without other limit
+			request.m_Time = hasTime ? time : 0.0;
+		}
+
+		//results are printed in completion order, with request index
+		BatchAnalyzer analyzer(threadCount, shareTranspositionTable);
+		analyzer.Analyze(requests, [](const AnalysisResult& result)
+		{
+			std::cout << result.m_Index;
+			if (!result.m_IsValid)
+			{
+				std::cout << " invalid" << std::endl;
+				return;
+			}
+
+			std::cout << " depth " << result.m_Depth << " score cp " << result.m_Score << " nodes " << result.m_NodeCount << " pv";
+			for (const Move& move : result.m_PrincipalVariation)
+				std::cout << " " << NotationParser::TranslateToUciString(move);
+			std::cout << std::endl;
+		});
+		return 0;
+	}
+
+	Tuner tuner(threadCount);
+	std::cout << "Loading " << positionsPath << " with " << threadCount << " threads" << std::endl;
+	if (!tuner.Load(positionsPath))
+	{
+		std::cout << "Can't read " << positionsPath << std::endl;
+		return 1;
+	}
+	std::cout << "Loaded " << tuner.GetPositionCount() << " quiet positions" << std::endl;
+
+	std::cout << "Scaling constant: " << tuner.TuneScalingConstant() << std::endl;
+	tuner.Tune(maxIterations, tunePieceSquareTables, outputPath);
+	std::cout << "Parameters written to " << outputPath << std::endl;
+
+	return 0;
+}
\ No newline at end of file
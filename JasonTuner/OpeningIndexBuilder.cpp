@@ -0,0 +1,193 @@
+#include "OpeningIndexBuilder.h"
+#include "NotationParser.h"
+#include "PackedPosition.h"
+#include "MappedFile.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <queue>
+#include <charconv>
+#include <cstdio>
+
+static int ReadRating(std::string_view tag)
+{
+	int rating = 0;
+	std::from_chars(tag.data(), tag.data() + tag.size(), rating);
+	return rating;
+}
+
+bool OpeningIndexBuilder::Build(const std::vector<std::string>& pgnPaths, const std::string& outputPath)
+{
+	m_OutputPath = outputPath;
+	m_HasWriteError = false;
+	m_GameCount = 0;
+	m_Entries.reserve(RunEntryCount);
+
+	PgnReader reader(m_ThreadCount);
+	for (const std::string& pgnPath : pgnPaths)
+	{
+		if (!reader.Read(pgnPath, [this](const PgnGame& game) { AddGame(game); }))
+		{
+			std::cout << "Can't read " << pgnPath << std::endl;
+			return false;
+		}
+		std::cout << "Games: " << m_GameCount << ", skipped games: " << reader.GetErrorCount() << std::endl;
+	}
+
+	if (!m_Entries.empty() && !WriteRun(m_Entries))
+		return false;
+
+	return !m_HasWriteError && MergeRuns(outputPath);
+}
+
+void OpeningIndexBuilder::AddGame(const PgnGame& game)
+{
+	static const Position StartPosition;
+
+	if (!game.m_HasResult)
+		return; //no statistics without result
+
+	Position position;
+	const std::string_view fen = game.GetTag("FEN");
+	if (fen.empty())
+		position = StartPosition;
+	else
+		NotationParser::ParseFEN(fen, position); //already read by PGN reader
+
+	const int ratings[2] = { ReadRating(game.GetTag("BlackElo")), ReadRating(game.GetTag("WhiteElo")) };
+	const size_t plyCount = std::min(game.m_Moves.size(), static_cast<size_t>(m_MaxPly));
+	std::vector<OpeningIndexEntry> entries(plyCount);
+	for (size_t ply = 0; ply < plyCount; ply++)
+	{
+		Move move = game.m_Moves[ply];
+		OpeningIndexEntry& entry = entries[ply];
+		entry.m_Key = position.GetZobristHash();
+		entry.m_Move = PackedPosition::PackMove(move);
+		entry.m_WhiteWins = (game.m_Result == 2) ? 1 : 0;
+		entry.m_Draws = (game.m_Result == 1) ? 1 : 0;
+		entry.m_BlackWins = (game.m_Result == 0) ? 1 : 0;
+		const int rating = ratings[position.IsWhiteToPlay() ? 1 : 0];
+		entry.m_RatingSum = std::max(rating, 0);
+		entry.m_RatedGameCount = (rating > 0) ? 1 : 0;
+		position.Update(move);
+	}
+	m_GameCount++;
+
+	std::vector<OpeningIndexEntry> runEntries;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Entries.insert(m_Entries.end(), entries.begin(), entries.end());
+		if (m_Entries.size() < RunEntryCount)
+			return;
+
+		runEntries.swap(m_Entries);
+		m_Entries.reserve(RunEntryCount);
+	}
+
+	//run is sorted and written outside of lock, other threads keep reading games
+	if (!WriteRun(runEntries))
+		m_HasWriteError = true;
+}
+
+bool OpeningIndexBuilder::WriteRun(std::vector<OpeningIndexEntry>& entries)
+{
+	std::sort(entries.begin(), entries.end());
+	size_t count = 0;
+	for (const OpeningIndexEntry& entry : entries)
+	{
+		if (count > 0 && entries[count - 1].IsSameMove(entry))
+			entries[count - 1].Merge(entry);
+		else
+			entries[count++] = entry;
+	}
+	entries.resize(count);
+
+	std::string runPath;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		runPath = m_OutputPath + ".run" + std::to_string(m_RunPaths.size());
+		m_RunPaths.push_back(runPath);
+	}
+
+	std::ofstream file(runPath, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(OpeningIndexEntry));
+	entries.clear();
+	return file.good();
+}
+
+bool OpeningIndexBuilder::MergeRuns(const std::string& outputPath)
+{
+	std::vector<MappedFile> runs(m_RunPaths.size());
+	for (size_t runIdx = 0; runIdx < runs.size(); runIdx++)
+	{
+		if (!runs[runIdx].Open(m_RunPaths[runIdx]))
+			return false;
+	}
+
+	std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	const OpeningIndexHeader header = OpeningIndexHeader::Create();
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	//next entry of each run, smallest first
+	using RunEntry = std::pair<OpeningIndexEntry, size_t>;
+	const auto isAfter = [](const RunEntry& entry1, const RunEntry& entry2) { return entry2.first < entry1.first; };
+	std::priority_queue<RunEntry, std::vector<RunEntry>, decltype(isAfter)> queue(isAfter);
+	std::vector<size_t> positions(runs.size(), 0);
+	const auto pushNextEntry = [&](size_t runIdx)
+	{
+		const OpeningIndexEntry* entries = reinterpret_cast<const OpeningIndexEntry*>(runs[runIdx].data());
+		if (positions[runIdx] < runs[runIdx].size() / sizeof(OpeningIndexEntry))
+			queue.emplace(entries[positions[runIdx]++], runIdx);
+	};
+	for (size_t runIdx = 0; runIdx < runs.size(); runIdx++)
+		pushNextEntry(runIdx);
+
+	std::vector<OpeningIndexEntry> buffer;
+	buffer.reserve(RunEntryCount / 16);
+	const auto writeEntry = [&](const OpeningIndexEntry& entry)
+	{
+		if (entry.GetGameCount() < m_MinGameCount)
+			return;
+
+		buffer.push_back(entry);
+		m_EntryCount++;
+		if (buffer.size() == buffer.capacity())
+		{
+			file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(OpeningIndexEntry));
+			buffer.clear();
+		}
+	};
+
+	m_EntryCount = 0;
+	std::optional<OpeningIndexEntry> current;
+	while (!queue.empty())
+	{
+		const RunEntry next = queue.top();
+		queue.pop();
+		pushNextEntry(next.second);
+
+		if (current.has_value() && current->IsSameMove(next.first))
+		{
+			current->Merge(next.first);
+			continue;
+		}
+
+		if (current.has_value())
+			writeEntry(*current);
+		current = next.first;
+	}
+
+	if (current.has_value())
+		writeEntry(*current);
+	file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(OpeningIndexEntry));
+
+	runs.clear();
+	for (const std::string& runPath : m_RunPaths)
+		std::remove(runPath.c_str());
+	m_RunPaths.clear();
+
+	return file.good();
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <stdint.h>
+#include "OpeningIndex.h"
+#include "PgnReader.h"
+
+/// <summary>
+/// Build an opening index from PGN files with an external sort-merge: entries are aggregated in memory until a run is full,
+/// runs are sorted and written by PGN reader threads, then all runs are merged into the index file
+/// </summary>
+/// <remark>Memory use is bounded by run size per thread, whatever the number of games</remark>
+class OpeningIndexBuilder
+{
+public:
+	/// <param name="maxPly">moves after max ply aren't indexed</param>
+	/// <param name="minGameCount">moves played in less games aren't written to index</param>
+	OpeningIndexBuilder(int threadCount, int maxPly, uint32_t minGameCount) : m_ThreadCount(threadCount), m_MaxPly(maxPly), m_MinGameCount(minGameCount) {};
+
+	/// <summary>Index games with a known result of PGN files</summary>
+	/// <returns>False if a file can't be read or written</returns>
+	bool Build(const std::vector<std::string>& pgnPaths, const std::string& outputPath);
+
+	uint64_t GetGameCount() const { return m_GameCount; };
+	uint64_t GetEntryCount() const { return m_EntryCount; };
+
+private:
+	static constexpr size_t RunEntryCount = 1 << 22; //entries sorted in memory at once, 160 MB
+
+	/// <summary>Entries of each move of game, until max ply</summary>
+	void AddGame(const PgnGame& game);
+
+	/// <summary>Sort entries, merge entries of same move and write them to a new run file</summary>
+	bool WriteRun(std::vector<OpeningIndexEntry>& entries);
+
+	/// <summary>Merge sorted run files into index file, run files are removed</summary>
+	bool MergeRuns(const std::string& outputPath);
+
+	int m_ThreadCount = 1;
+	int m_MaxPly = 0;
+	uint32_t m_MinGameCount = 1;
+	std::string m_OutputPath;
+	std::atomic<bool> m_HasWriteError = false;
+	std::atomic<uint64_t> m_GameCount = 0;
+	uint64_t m_EntryCount = 0;
+
+	std::mutex m_Mutex; //protects members below
+	std::vector<OpeningIndexEntry> m_Entries; //entries of current run
+	std::vector<std::string> m_RunPaths;
+};
\ No newline at end of file
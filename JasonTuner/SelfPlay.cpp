@@ -0,0 +1,67 @@
+#include "SelfPlay.h"
+#include "MoveMaker.h"
+#include "MoveSearcher.h"
+#include <memory>
+#include <chrono>
+#include <algorithm>
+
+double SelfPlay::PlayGame(const SearchParameters& white, const SearchParameters& black, const std::vector<Move>& opening, double time, double increment)
+{
+	//each side has its own transposition table
+	std::unique_ptr<MoveMaker> whiteMoveMaker = std::make_unique<MoveMaker>();
+	std::unique_ptr<MoveMaker> blackMoveMaker = std::make_unique<MoveMaker>();
+	whiteMoveMaker->SetSearchParameters(white);
+	blackMoveMaker->SetSearchParameters(black);
+
+	Position position;
+	for (Move move : opening)
+		position.Update(move);
+
+	double whiteTime = time;
+	double blackTime = time;
+	return GameLoop::Play(position, Adjudication, *whiteMoveMaker, [&](Position& gamePosition, int ply, int& whiteScore)
+	{
+		const bool isWhiteToPlay = gamePosition.IsWhiteToPlay();
+		MoveMaker& moveMaker = isWhiteToPlay ? *whiteMoveMaker : *blackMoveMaker;
+		double& remainingTime = isWhiteToPlay ? whiteTime : blackTime;
+
+		//MoveMaker score is from white point of view
+		int searchDepth = 0;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const bool moveFound = moveMaker.MakeMove(remainingTime, false, increment, gamePosition, MaxPvLength, whiteScore, searchDepth);
+		remainingTime += increment - std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		return moveFound && (remainingTime >= 0.0); //lost on time otherwise
+	});
+}
+
+double SelfPlay::PlayGamePair(const SearchParameters& first, const SearchParameters& second, const std::vector<Move>& opening, double time, double increment)
+{
+	return PlayGame(first, second, opening, time, increment) + (1.0 - PlayGame(second, first, opening, time, increment));
+}
+
+std::vector<Move> SelfPlay::GetRandomOpening(std::mt19937& generator, int plies)
+{
+	std::vector<Move> opening;
+	Position position;
+	MoveList<MaxMoves> moves;
+	MoveSearcher::GetLegalMovesFromBitboards(position, moves);
+	while (static_cast<int>(opening.size()) < plies)
+	{
+		Move move = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(generator)];
+		position.Update(move);
+		opening.push_back(move);
+
+		//no legal moves after checkmate, stalemate or repetition
+		MoveSearcher::GetLegalMovesFromBitboards(position, moves);
+		if (moves.empty() || position.IsInsufficientMaterialFromBitboards())
+		{
+			//start again
+			opening.clear();
+			position = Position();
+			MoveSearcher::GetLegalMovesFromBitboards(position, moves);
+		}
+	}
+
+	return opening;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include <random>
+#include "Position.h"
+#include "SearchParameters.h"
+#include "GameLoop.h"
+
+/// <summary>Games between two sets of search parameters, played in process</summary>
+class SelfPlay
+{
+public:
+	/// <summary>Play a game from position reached after opening moves, each side has time + increment per move</summary>
+	/// <remark>Game is adjudicated as a draw after GameLoop::MaxGamePlies, and as a win when both sides agree on a winning score</remark>
+	/// <returns>Result for white: 1 for a win, 0.5 for a draw, 0 for a loss</returns>
+	static double PlayGame(const SearchParameters& white, const SearchParameters& black, const std::vector<Move>& opening, double time, double increment);
+
+	/// <summary>Play a game with each color, from the same opening</summary>
+	/// <returns>Score of first parameters, from 0 to 2</returns>
+	static double PlayGamePair(const SearchParameters& first, const SearchParameters& second, const std::vector<Move>& opening, double time, double increment);
+
+	/// <returns>Random legal moves from start position, which don't end the game</returns>
+	static std::vector<Move> GetRandomOpening(std::mt19937& generator, int plies);
+
+private:
+	static constexpr AdjudicationSettings Adjudication = { 1000, 4 }; //win score and plies, no draw adjudication
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "Spsa.h"
+#include "SelfPlay.h"
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+SearchParameters Spsa::Run(int iterations, const std::string& outputPath)
+{
+	const SearchParameters defaultParameters;
+	for (size_t i = 0; i < ParametersCount; i++)
+		m_Values[i] = defaultParameters.*SearchParameterDescriptions[i].m_Value;
+	m_Iteration = 0;
+
+	std::vector<std::thread> threads;
+	for (int threadIdx = 0; threadIdx < m_ThreadCount; threadIdx++)
+		threads.emplace_back(&Spsa::RunThread, this, iterations, outputPath);
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	const SearchParameters parameters = GetParameters(m_Values);
+	if (!outputPath.empty())
+		WriteParameters(parameters, outputPath);
+
+	return parameters;
+}
+
+void Spsa::RunThread(int iterations, const std::string& outputPath)
+{
+	std::mt19937 generator;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		generator.seed(m_Generator());
+	}
+
+	const double stability = 0.1 * iterations; //delays learning rate decay, over first iterations
+	while (true)
+	{
+		int iteration = 0;
+		std::array<double, ParametersCount> perturbations = {};
+		std::array<double, ParametersCount> plusValues = {};
+		std::array<double, ParametersCount> minusValues = {};
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_Iteration >= iterations)
+				return;
+
+			iteration = ++m_Iteration;
+			for (size_t i = 0; i < ParametersCount; i++)
+			{
+				const SearchParameterDescription& description = SearchParameterDescriptions[i];
+				const double perturbation = std::max(PerturbationRatio * (description.m_Max - description.m_Min) / std::pow(iteration, Gamma), MinPerturbation);
+				perturbations[i] = (generator() & 1) ? perturbation : -perturbation;
+				plusValues[i] = m_Values[i] + perturbations[i];
+				minusValues[i] = m_Values[i] - perturbations[i];
+			}
+		}
+
+		const double result = PlayGamePair(GetParameters(plusValues), GetParameters(minusValues), generator) - 1.0;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		const double learningRate = LearningRate * std::pow(stability + 1.0, Alpha) / std::pow(stability + iteration, Alpha);
+		for (size_t i = 0; i < ParametersCount; i++)
+		{
+			const SearchParameterDescription& description = SearchParameterDescriptions[i];
+			m_Values[i] = std::clamp(m_Values[i] + learningRate * result * perturbations[i], static_cast<double>(description.m_Min), static_cast<double>(description.m_Max));
+		}
+
+		if (iteration % m_ThreadCount == 0)
+		{
+			std::cout << "Iteration " << iteration << ":";
+			for (size_t i = 0; i < ParametersCount; i++)
+				std::cout << " " << SearchParameterDescriptions[i].m_Name << "=" << m_Values[i];
+			std::cout << std::endl;
+
+			if (!outputPath.empty())
+				WriteParameters(GetParameters(m_Values), outputPath);
+		}
+	}
+}
+
+double Spsa::PlayGamePair(const SearchParameters& plusParameters, const SearchParameters& minusParameters, std::mt19937& generator)
+{
+	const std::vector<Move> opening = SelfPlay::GetRandomOpening(generator, GameLoop::OpeningPlies);
+	return SelfPlay::PlayGamePair(plusParameters, minusParameters, opening, m_Time, m_Increment);
+}
+
+SearchParameters Spsa::GetParameters(const std::array<double, ParametersCount>& values)
+{
+	SearchParameters parameters;
+	for (size_t i = 0; i < ParametersCount; i++)
+	{
+		const SearchParameterDescription& description = SearchParameterDescriptions[i];
+		parameters.*description.m_Value = std::clamp(static_cast<int>(std::lround(values[i])), description.m_Min, description.m_Max);
+	}
+
+	return parameters;
+}
+
+void Spsa::WriteParameters(const SearchParameters& parameters, const std::string& path)
+{
+	//as uci commands, so that file can be sent to engine
+	std::ofstream file(path);
+	for (const SearchParameterDescription& description : SearchParameterDescriptions)
+		file << "setoption name " << description.m_Name << " value " << parameters.*description.m_Value << "\n";
+}
\ No newline at end of file
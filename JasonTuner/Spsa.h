@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <string>
+#include <random>
+#include <mutex>
+#include <stdint.h>
+#include "SearchParameters.h"
+
+/// <summary>
+/// SPSA tuning of search parameters: all parameters are perturbed at once in random directions,
+/// and moved toward the perturbation which wins a self-play game pair
+/// </summary>
+/// <remark>Each thread plays game pairs and updates parameters as soon as its games are over</remark>
+class Spsa
+{
+public:
+	/// <param name="time">time per game for each side, in seconds</param>
+	/// <param name="increment">time increment per move, in seconds</param>
+	/// <param name="seed">seed of perturbation directions and openings</param>
+	Spsa(int threadCount, double time, double increment, uint32_t seed = std::mt19937::default_seed) : m_ThreadCount(threadCount), m_Time(time), m_Increment(increment), m_Generator(seed) {};
+	virtual ~Spsa() = default;
+
+	/// <summary>Play game pairs until iterations are done, parameters are written every thread count iterations if path isn't empty</summary>
+	/// <returns>Tuned parameters</returns>
+	SearchParameters Run(int iterations, const std::string& outputPath);
+
+	static void WriteParameters(const SearchParameters& parameters, const std::string& path);
+
+protected:
+	/// <summary>Play a self-play game pair from a random opening</summary>
+	/// <returns>Score of plus parameters, from 0 to 2</returns>
+	virtual double PlayGamePair(const SearchParameters& plusParameters, const SearchParameters& minusParameters, std::mt19937& generator);
+
+private:
+	static constexpr size_t ParametersCount = SearchParameterDescriptions.size();
+	static constexpr double Alpha = 0.602; //learning rate decay
+	static constexpr double Gamma = 0.101; //perturbation decay
+	static constexpr double LearningRate = 1.0; //first update is learning rate * perturbation per won game
+	static constexpr double PerturbationRatio = 0.05; //first perturbation, relative to parameter range
+	static constexpr double MinPerturbation = 1.0; //decayed perturbations are clamped to it, so that rounded plus and minus parameters always differ
+
+	/// <summary>Play game pairs on one thread</summary>
+	void RunThread(int iterations, const std::string& outputPath);
+
+	/// <returns>Parameters rounded to nearest integer and clamped to bounds</returns>
+	static SearchParameters GetParameters(const std::array<double, ParametersCount>& values);
+
+	int m_ThreadCount = 1;
+	double m_Time = 0.0;
+	double m_Increment = 0.0;
+
+	std::mutex m_Mutex; //protects members below
+	std::array<double, ParametersCount> m_Values = {};
+	int m_Iteration = 0;
+	std::mt19937 m_Generator;
+};
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "Tuner.h"
+#include "MoveMaker.h"
+#include "MoveSearcher.h"
+#include "NotationParser.h"
+#include "PositionEvaluation.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <thread>
+#include <memory>
+#include <cmath>
+
+static constexpr size_t LinesPerBatch = 1 << 20; //lines read before being filtered in parallel, bounds memory used by text
+static constexpr size_t PackedPositionsPerBatch = 1 << 20; //packed positions filtered in parallel at once, between progress reports
+
+/// <summary>Run function(threadIdx, begin, end) on slices of [0, size[, one per thread</summary>
+template<class Function>
+static void RunInParallel(int threadCount, size_t size, const Function& function)
+{
+	std::vector<std::thread> threads;
+	const size_t sliceSize = (size + threadCount - 1) / threadCount;
+	for (int threadIdx = 0; threadIdx < threadCount; threadIdx++)
+	{
+		const size_t begin = std::min(size, threadIdx * sliceSize);
+		const size_t end = std::min(size, begin + sliceSize);
+		threads.emplace_back(function, threadIdx, begin, end);
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+/// <returns>Expected result (1 white wins, 0 black wins) from a score in centipawns</returns>
+static double Sigmoid(double scalingConstant, int score)
+{
+	return 1.0 / (1.0 + std::pow(10.0, -scalingConstant * score / 400.0));
+}
+
+bool Tuner::Load(const std::string& path)
+{
+	if (path.size() > 4 && path.compare(path.size() - 4, 4, ".bin") == 0)
+		return LoadPackedPositions(path);
+
+	std::ifstream file(path);
+	if (!file.is_open())
+		return false;
+
+	std::vector<std::string> lines;
+	size_t lineCount = 0;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		lines.push_back(line);
+		if (lines.size() == LinesPerBatch)
+		{
+			AddQuietPositions(lines.size(), [&lines](size_t i) { return Parse(lines[i]); });
+			lineCount += lines.size();
+			lines.clear();
+			std::cout << "Read " << lineCount << " lines, kept " << m_Positions.size() << " quiet positions" << std::endl;
+		}
+	}
+	AddQuietPositions(lines.size(), [&lines](size_t i) { return Parse(lines[i]); });
+
+	return true;
+}
+
+bool Tuner::LoadPackedPositions(const std::string& path)
+{
+	PackedPositionReader reader;
+	if (!reader.Open(path))
+		return false;
+
+	for (size_t begin = 0; begin < reader.size(); begin += PackedPositionsPerBatch)
+	{
+		const size_t count = std::min(PackedPositionsPerBatch, reader.size() - begin);
+		AddQuietPositions(count, [&reader, begin](size_t i) { return std::optional<PackedPosition>(reader[begin + i]); });
+		std::cout << "Read " << begin + count << " positions, kept " << m_Positions.size() << " quiet positions" << std::endl;
+	}
+
+	return true;
+}
+
+void Tuner::AddQuietPositions(size_t count, const std::function<std::optional<PackedPosition>(size_t)>& getPosition)
+{
+	std::vector<std::vector<PackedPosition>> quietPositions(m_ThreadCount);
+	RunInParallel(m_ThreadCount, count, [&](int threadIdx, size_t begin, size_t end)
+	{
+		std::unique_ptr<MoveMaker> moveMaker = std::make_unique<MoveMaker>(); //each thread has its own transposition table
+		Position position;
+		for (size_t i = begin; i < end; i++)
+		{
+			const std::optional<PackedPosition> packedPosition = getPosition(i);
+			if (!packedPosition.has_value())
+				continue;
+
+			if (!packedPosition->Unpack(position) || position.GetWhiteKing().CountSetBits() != 1 || position.GetBlackKing().CountSetBits() != 1)
+				continue; //corrupted record or position without kings
+
+			if (MoveSearcher::IsKingInCheckFromBitboards(position, position.IsWhiteToPlay()))
+				continue;
+
+			const int score = PositionEvaluation::EvaluatePosition(position, 0);
+			if (moveMaker->GetQuiescentScore(position) == score)
+				quietPositions[threadIdx].push_back(*packedPosition);
+		}
+	});
+
+	for (const std::vector<PackedPosition>& positions : quietPositions)
+		m_Positions.insert(m_Positions.end(), positions.begin(), positions.end());
+}
+
+std::optional<PackedPosition> Tuner::Parse(const std::string& line)
+{
+	//FEN is made of board, side to play, castling rights and en passant square, move clocks are ignored
+	std::istringstream stream(line);
+	std::string fen;
+	for (int fieldIdx = 0; fieldIdx < 4; fieldIdx++)
+	{
+		std::string field;
+		if (!(stream >> field))
+			return std::nullopt;
+		fen += field + " ";
+	}
+
+	const std::string remainder = line.substr(std::min(line.size(), static_cast<size_t>(stream.tellg())));
+	uint8_t result = 0;
+	if (remainder.find("1/2-1/2") != std::string::npos || remainder.find("[0.5]") != std::string::npos)
+		result = 1;
+	else if (remainder.find("1-0") != std::string::npos || remainder.find("[1.0]") != std::string::npos)
+		result = 2;
+	else if (remainder.find("0-1") != std::string::npos || remainder.find("[0.0]") != std::string::npos)
+		result = 0;
+	else
+		return std::nullopt;
+
+	Position position;
+	if (!NotationParser::ParseFEN(fen, position))
+		return std::nullopt;
+
+	std::optional<PackedPosition> packedPosition = PackedPosition::Pack(position);
+	if (packedPosition.has_value())
+		packedPosition->m_Result = result;
+
+	return packedPosition;
+}
+
+double Tuner::ComputeError(double scalingConstant) const
+{
+	std::vector<double> errors(m_ThreadCount, 0.0);
+	RunInParallel(m_ThreadCount, m_Positions.size(), [&](int threadIdx, size_t begin, size_t end)
+	{
+		double error = 0.0;
+		Position position;
+		for (size_t i = begin; i < end; i++)
+		{
+			m_Positions[i].Unpack(position);
+			const double result = m_Positions[i].m_Result / 2.0;
+			const double difference = result - Sigmoid(scalingConstant, PositionEvaluation::EvaluatePosition(position, 0));
+			error += difference * difference;
+		}
+		errors[threadIdx] = error;
+	});
+
+	double error = 0.0;
+	for (double threadError : errors)
+		error += threadError;
+
+	return m_Positions.empty() ? 0.0 : error / m_Positions.size();
+}
+
+double Tuner::TuneScalingConstant()
+{
+	//error is convex in scaling constant, refine step around best value
+	double bestError = ComputeError(m_ScalingConstant);
+	for (double step = 0.1; step > 0.0005; step /= 10.0)
+	{
+		bool improved = true;
+		while (improved)
+		{
+			improved = false;
+			for (double candidate : { m_ScalingConstant + step, m_ScalingConstant - step })
+			{
+				const double error = ComputeError(candidate);
+				if (error < bestError)
+				{
+					bestError = error;
+					m_ScalingConstant = candidate;
+					improved = true;
+					break;
+				}
+			}
+		}
+	}
+
+	return m_ScalingConstant;
+}
+
+std::vector<int> Tuner::Tune(int maxIterations, bool tunePieceSquareTables, const std::string& outputPath)
+{
+	std::vector<int> parameters = PositionEvaluation::GetParameters();
+	const size_t scalarParametersCount = PositionEvaluation::NumberOfScalarParameters; //followed by piece-square tables
+	const size_t tunedParametersCount = tunePieceSquareTables ? parameters.size() : scalarParametersCount;
+
+	PositionEvaluation::LoadParameters(parameters);
+	double bestError = ComputeError(m_ScalingConstant);
+	std::cout << "Initial error: " << bestError << std::endl;
+
+	for (int iteration = 1; iteration <= maxIterations; iteration++)
+	{
+		bool improved = false;
+		for (size_t i = 0; i < tunedParametersCount; i++)
+		{
+			if (i >= scalarParametersCount)
+			{
+				//pawns can't stand on first and last ranks
+				const size_t tableIdx = (i - scalarParametersCount) % (6 * 64);
+				const size_t squareIdx = tableIdx % 64;
+				if ((tableIdx / 64 == static_cast<size_t>(PieceType::Pawn)) && (squareIdx < 8 || squareIdx >= 56))
+					continue;
+			}
+
+			for (int step : { 1, -1 })
+			{
+				parameters[i] += step;
+				PositionEvaluation::LoadParameters(parameters);
+				const double error = ComputeError(m_ScalingConstant);
+				if (error < bestError)
+				{
+					bestError = error;
+					improved = true;
+					break;
+				}
+				parameters[i] -= step;
+			}
+		}
+
+		PositionEvaluation::LoadParameters(parameters);
+		std::cout << "Iteration " << iteration << ", error: " << bestError << std::endl;
+		if (!outputPath.empty())
+			WriteParameters(parameters, outputPath);
+
+		if (!improved)
+			break;
+	}
+
+	return parameters;
+}
+
+void Tuner::WriteParameters(const std::vector<int>& parameters, const std::string& path)
+{
+	std::ofstream file(path);
+	for (size_t i = 0; i < parameters.size(); i++)
+		file << parameters[i] << ((i + 1 < parameters.size()) ? ", " : "\n");
+}
\ No newline at end of file
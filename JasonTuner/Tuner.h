@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <string>
+#include <optional>
+#include <functional>
+#include <stdint.h>
+#include "Position.h"
+#include "PackedPosition.h"
+
+/// <summary>
+/// Texel tuning of evaluation parameters: minimize mean squared error between game results and sigmoid of static evaluations
+/// </summary>
+/// <remark>Positions are loaded and evaluated in parallel, each thread with its own search and evaluation caches</remark>
+class Tuner
+{
+public:
+	Tuner(int threadCount) : m_ThreadCount(threadCount) {};
+
+	/// <summary>Load labeled positions, one per line: FEN followed by game result ("1-0", "0-1", "1/2-1/2", "[1.0]", "[0.5]" or "[0.0]")</summary>
+	/// <remark>Files with .bin extension are read as packed positions, e.g. written by data generator</remark>
+	/// <remark>Positions in check and positions which are not quiet (quiescent search differs from static evaluation) are skipped</remark>
+	/// <returns>False if file can't be read</returns>
+	bool Load(const std::string& path);
+	size_t GetPositionCount() const { return m_Positions.size(); };
+
+	/// <summary>Find sigmoid scaling constant minimizing error with current parameters</summary>
+	double TuneScalingConstant();
+
+	/// <returns>Mean squared error between game results and sigmoid of static evaluations, with current parameters</returns>
+	double ComputeError(double scalingConstant) const;
+
+	/// <summary>Local search: change each parameter by +1 or -1 as long as error is reduced, until no parameter changes or max iterations</summary>
+	/// <param name="tunePieceSquareTables">tune piece-square tables too, otherwise only scalar parameters</param>
+	/// <param name="outputPath">parameters are written after every iteration if not empty</param>
+	/// <returns>Tuned parameters, also loaded in evaluation</returns>
+	std::vector<int> Tune(int maxIterations, bool tunePieceSquareTables, const std::string& outputPath);
+
+	/// <returns>Labeled position from a line of the input file, nullopt if line can't be parsed</returns>
+	static std::optional<PackedPosition> Parse(const std::string& line);
+
+private:
+	/// <summary>Keep positions which aren't in check and are quiet, in parallel</summary>
+	/// <param name="getPosition">returns position from its index, nullopt if it can't be read</param>
+	void AddQuietPositions(size_t count, const std::function<std::optional<PackedPosition>(size_t)>& getPosition);
+
+	/// <summary>Load binary file of packed positions, memory mapped</summary>
+	bool LoadPackedPositions(const std::string& path);
+
+	static void WriteParameters(const std::vector<int>& parameters, const std::string& path);
+
+	int m_ThreadCount = 1;
+	double m_ScalingConstant = 1.0;
+	std::vector<PackedPosition> m_Positions;
+
+	friend class TunerTests;
+};
\ No newline at end of file
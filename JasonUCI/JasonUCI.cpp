@@ -2,7 +2,10 @@
 #include <string>
 #include "MoveMaker.h"
 #include "NotationParser.h"
+#include "OpeningIndex.h"
+#include "PackedPosition.h"
 #include <fstream>
+#include <algorithm>
 
 static std::string GetLastWord(const std::string& s)
 {
@@ -99,6 +102,76 @@ static void ParseGoCommand(const std::string& line, double& wtime, double& btime
 	}
 }
 
+/// <summary>Parse optional "depth" and "nodes" limits of go command, max depth is kept if there is none</summary>
+static void ParseSearchLimits(const std::string& line, int& maxDepth, uint64_t& nodeLimit)
+{
+	nodeLimit = 0;
+	size_t idx = line.find("nodes");
+	if (idx != std::string::npos)
+	{
+		idx += 6;
+		nodeLimit = std::stoull(GetFirstWord(line.substr(idx, std::string::npos)));
+		maxDepth = MaxPvLength; //nodes are the limit
+	}
+
+	idx = line.find("depth");
+	if (idx != std::string::npos)
+	{
+		idx += 6;
+		maxDepth = std::stoi(GetFirstWord(line.substr(idx, std::string::npos)));
+	}
+}
+
+static void PrintSearchInfo(const SearchInfo& info)
+{
+	std::cout << "info depth " << info.m_Depth;
+	std::optional<int> mateCount = PositionEvaluation::GetMovesToMate(info.m_Score);
+	if (mateCount.has_value())
+		std::cout << " score mate " << (info.m_Score > 0 ? *mateCount : -*mateCount);
+	else
+		std::cout << " score cp " << info.m_Score;
+
+	const int timeMs = static_cast<int>(info.m_Time * 1000.0);
+	std::cout << " nodes " << info.m_NodeCount;
+	std::cout << " nps " << static_cast<uint64_t>(info.m_NodeCount / std::max(info.m_Time, 0.001));
+	std::cout << " time " << timeMs;
+	std::cout << " pv";
+	for (const Move& move : *info.m_PrincipalVariation)
+		std::cout << " " << NotationParser::TranslateToUciString(move);
+	std::cout << std::endl;
+}
+
+/// <summary>Print moves of opening index played in position, for non standard "explore" command</summary>
+static void PrintExploredMoves(const OpeningIndex& openingIndex, const Position& position)
+{
+	for (const OpeningIndexEntry& entry : openingIndex.GetMoves(position))
+	{
+		const std::optional<Move> move = PackedPosition::UnpackMove(position, entry.m_Move);
+		if (!move.has_value())
+			continue; //hash collision
+
+		const uint32_t gameCount = entry.GetGameCount();
+		const uint32_t moverWins = position.IsWhiteToPlay() ? entry.m_WhiteWins : entry.m_BlackWins;
+		std::cout << NotationParser::TranslateToUciString(*move) << " games " << gameCount
+			<< " +" << entry.m_WhiteWins << " =" << entry.m_Draws << " -" << entry.m_BlackWins
+			<< " score " << (100.0 * (moverWins + 0.5 * entry.m_Draws) / gameCount) << "%"
+			<< " rating " << entry.GetAverageRating() << std::endl;
+	}
+}
+
+/// <summary>Parse "setoption name [name] value [value]" command</summary>
+static bool ParseSetOption(const std::string& line, std::string& name, std::string& value)
+{
+	const size_t nameIdx = line.find("name ");
+	if (nameIdx == std::string::npos)
+		return false;
+
+	const size_t valueIdx = line.find(" value ", nameIdx);
+	name = line.substr(nameIdx + 5, valueIdx == std::string::npos ? std::string::npos : valueIdx - nameIdx - 5);
+	value = (valueIdx == std::string::npos) ? std::string() : line.substr(valueIdx + 7);
+	return true;
+}
+
 int main()
 {
 	std::string line;
@@ -107,6 +180,10 @@ int main()
 	//Initialization
 	Position position;
 	MoveMaker moveMaker;
+	moveMaker.SetIterationCallback(PrintSearchInfo);
+	SearchParameters searchParameters;
+	PolyglotBook book;
+	OpeningIndex openingIndex;
 	bool isGameOver = false;
 	int score = 0;
 
@@ -118,12 +195,72 @@ int main()
 		{
 			std::cout << "id name Jason" << std::endl;
 			std::cout << "id Romain Fournet" << std::endl;
+			std::cout << "option name UseNNUE type check default false" << std::endl;
+			std::cout << "option name EvalFile type string default <empty>" << std::endl;
+			std::cout << "option name ParametersFile type string default <empty>" << std::endl;
+			std::cout << "option name OwnBook type check default false" << std::endl;
+			std::cout << "option name BookFile type string default <empty>" << std::endl;
+			std::cout << "option name ExplorerFile type string default <empty>" << std::endl;
+			for (const SearchParameterDescription& description : SearchParameterDescriptions)
+			{
+				std::cout << "option name " << description.m_Name << " type spin default " << searchParameters.*description.m_Value
+					<< " min " << description.m_Min << " max " << description.m_Max << std::endl;
+			}
 			std::cout << "uciok" << std::endl;
 		}
 		else if (line == "isready")
 		{
 			std::cout << "readyok" << std::endl;
 		}
+		else if (line.substr(0, 9) == "setoption")
+		{
+			std::string name;
+			std::string value;
+			if (!ParseSetOption(line, name, value))
+				continue;
+
+			if (name == "UseNNUE")
+			{
+				NeuralNetwork::SetUse(value == "true");
+			}
+			else if (name == "EvalFile")
+			{
+				if (NeuralNetwork::Load(value))
+					position.ComputeAccumulator();
+				else
+					std::cout << "info string could not load network " << value << std::endl;
+			}
+			else if (name == "ParametersFile")
+			{
+				//evaluation parameters written by tuner, piece-square scores of current position depend on them
+				if (PositionEvaluation::LoadParameters(value))
+					position.ComputePieceSquareScores();
+				else
+					std::cout << "info string could not load parameters " << value << std::endl;
+			}
+			else if (name == "OwnBook")
+			{
+				moveMaker.SetBook(value == "true" ? &book : nullptr);
+			}
+			else if (name == "BookFile")
+			{
+				if (!book.Open(value))
+					std::cout << "info string could not load book " << value << std::endl;
+			}
+			else if (name == "ExplorerFile")
+			{
+				if (!openingIndex.Open(value))
+					std::cout << "info string could not load opening index " << value << std::endl;
+			}
+			else if (FindSearchParameterDescription(name))
+			{
+				//values out of advertised bounds are clamped, non numeric values are ignored
+				if (searchParameters.Set(name, value))
+					moveMaker.SetSearchParameters(searchParameters);
+				else
+					std::cout << "info string invalid value " << value << " for " << name << std::endl;
+			}
+		}
 		else if (line == "ucinewgame")
 		{
 			position = Position();
@@ -132,7 +269,9 @@ int main()
 		{
 			if (line.substr(0, 12) == "position fen")
 			{
-				const std::string fenString = line.substr(12, std::string::npos);
+				//moves are not part of FEN, their letters would be read as en passant file
+				const size_t fenEndIdx = line.find(" moves");
+				const std::string fenString = line.substr(12, fenEndIdx == std::string::npos ? std::string::npos : fenEndIdx - 12);
 				position = Position(fenString);
 			}
 			else if (line.substr(0, 17) == "position startpos")
@@ -166,7 +305,11 @@ int main()
 			bool isMoveTime = false;
 			ParseGoCommand(line, wtime, btime, winc, binc, isMoveTime);
 
-			constexpr int maxDepth = 8;
+			int maxDepth = 8;
+			uint64_t nodeLimit = 0;
+			ParseSearchLimits(line, maxDepth, nodeLimit);
+			moveMaker.SetNodeLimit(nodeLimit);
+
 			int actualSearchDepth = 1;
 			double maxTime = position.IsWhiteToPlay() ? wtime : btime;
 			double timeIncrement = position.IsWhiteToPlay() ? winc : binc;
@@ -177,16 +320,22 @@ int main()
 				continue;
 			}
 
-			const std::string moveString = NotationParser::TranslateToUciString(position.GetMoves().back());
-			std::cout << "bestmove " << moveString << std::endl;
+			if (actualSearchDepth == 0)
+				std::cout << "info string book move" << std::endl;
 
-			std::cout << "info depth " << actualSearchDepth;
-			std::cout << " score cp " << static_cast<int>(score);
-			std::optional<int> mateCount = PositionEvaluation::GetMovesToMate(score);
-			if (mateCount.has_value())
-				std::cout << " mate " << *mateCount;
+			const Move& bestMove = position.GetMoves().back();
+			std::cout << "bestmove " << NotationParser::TranslateToUciString(bestMove);
+
+			//principal variation is the one of last complete iteration, best move can come from a later aspiration window failure or the book
+			const MoveList<MaxPvLength>& principalVariation = moveMaker.GetPrincipalVariation();
+			if ((principalVariation.size() > 1) && (principalVariation.front() == bestMove))
+				std::cout << " ponder " << NotationParser::TranslateToUciString(principalVariation[1]);
 			std::cout << std::endl;
 		}
+		else if (line == "explore")
+		{
+			PrintExploredMoves(openingIndex, position);
+		}
 		else if (line == "stop")
 		{
 			// nothing to do